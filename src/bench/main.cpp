@@ -0,0 +1,167 @@
+#include "card_textures.h"
+#include "core/card.h"
+#include "core/game_state.h"
+#include "core/mcts.h"
+#include "core/playout.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace std;
+using namespace uno;
+
+// Dealt positions shared by the benchmarks, so every run sees the same games.
+static const vector<GameState>& dealtGames() {
+    static const vector<GameState> games = [] {
+        Xoshiro256 rng(1);
+        vector<GameState> dealt(256);
+        for (auto& state : dealt) {
+            CardPile deck = makeDeck();
+            shuffle(deck, rng);
+            state.deal(deck, rng());
+        }
+        return dealt;
+    }();
+    return games;
+}
+
+static void BM_MakeDeck(benchmark::State& st) {
+    for (auto _ : st) {
+        CardPile deck = makeDeck();
+        benchmark::DoNotOptimize(deck);
+    }
+}
+BENCHMARK(BM_MakeDeck);
+
+static void BM_Shuffle(benchmark::State& st) {
+    CardPile deck = makeDeck();
+    Xoshiro256 rng(1);
+    for (auto _ : st) {
+        shuffle(deck, rng);
+        benchmark::DoNotOptimize(deck);
+    }
+}
+BENCHMARK(BM_Shuffle);
+
+// canPlay() over every card of the deck against a rotating top card.
+static void BM_CanPlay(benchmark::State& st) {
+    const CardPile deck = makeDeck();
+    size_t next = 0;
+    for (auto _ : st) {
+        Card top = deck[next++ % DECK_SIZE];
+        int playable = 0;
+        for (Card card : deck) playable += canPlay(card, top, top.color());
+        benchmark::DoNotOptimize(playable);
+    }
+    st.SetItemsProcessed(st.iterations() * DECK_SIZE);
+}
+BENCHMARK(BM_CanPlay);
+
+// What aiTurn used to do: canPlay() card by card into a playable set, for
+// hands of range(0) cards.
+static void BM_CanPlayHandLoop(benchmark::State& st) {
+    CardPile deck = makeDeck();
+    Xoshiro256 rng(1);
+    shuffle(deck, rng);
+    size_t count = st.range(0);
+    size_t next = 0;
+    for (auto _ : st) {
+        Card top = deck[next++ % DECK_SIZE];
+        uint64_t mask = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (canPlay(deck[i], top, top.color())) mask |= 1ull << i;
+        }
+        benchmark::DoNotOptimize(mask);
+    }
+    st.SetItemsProcessed(st.iterations() * count);
+}
+BENCHMARK(BM_CanPlayHandLoop)->Arg(7)->Arg(32)->Arg(64);
+
+static void BM_PlayableMask(benchmark::State& st) {
+    CardPile deck = makeDeck();
+    Xoshiro256 rng(1);
+    shuffle(deck, rng);
+    size_t count = st.range(0);
+    size_t next = 0;
+    for (auto _ : st) {
+        Card top = deck[next++ % DECK_SIZE];
+        benchmark::DoNotOptimize(playableMask(deck.cards, count, top, top.color()));
+    }
+    st.SetItemsProcessed(st.iterations() * count);
+}
+BENCHMARK(BM_PlayableMask)->Arg(7)->Arg(32)->Arg(64);
+
+// The same question for a whole hand as one mask AND.
+static void BM_PlayableFaces(benchmark::State& st) {
+    const auto& games = dealtGames();
+    size_t next = 0;
+    for (auto _ : st) {
+        const GameState& state = games[next++ % games.size()];
+        benchmark::DoNotOptimize(state.playableFaces(PLAYER_SEAT));
+    }
+}
+BENCHMARK(BM_PlayableFaces);
+
+static void BM_PlayGame(benchmark::State& st) {
+    const auto& games = dealtGames();
+    GameState state;
+    size_t next = 0;
+    long turns = 0;
+    for (auto _ : st) {
+        state = games[next++ % games.size()];
+        benchmark::DoNotOptimize(playGame(state, 2000));
+        turns += state.turnCount;
+    }
+    st.counters["turns/game"] = benchmark::Counter((double)turns / st.iterations());
+}
+BENCHMARK(BM_PlayGame);
+
+static void BM_RandomPlayout(benchmark::State& st) {
+    const auto& games = dealtGames();
+    Xoshiro256 rng(1);
+    size_t next = 0;
+    for (auto _ : st) {
+        Playout playout;
+        loadPlayout(playout, games[next++ % games.size()]);
+        benchmark::DoNotOptimize(runPlayout(playout, rng, 2000));
+    }
+}
+BENCHMARK(BM_RandomPlayout);
+
+static void BM_ChooseAiMove(benchmark::State& st) {
+    const auto& games = dealtGames();
+    size_t next = 0;
+    for (auto _ : st) {
+        benchmark::DoNotOptimize(chooseAiMove(games[next++ % games.size()], PLAYER_SEAT));
+    }
+}
+BENCHMARK(BM_ChooseAiMove);
+
+// One IS-MCTS decision with a fixed number of playouts, single threaded.
+static void BM_SearchMove(benchmark::State& st) {
+    const auto& games = dealtGames();
+    SearchOptions options;
+    options.timeBudget = 0.0;
+    options.maxPlayouts = st.range(0);
+    size_t next = 0;
+    for (auto _ : st) {
+        benchmark::DoNotOptimize(searchMove(games[next % games.size()], PLAYER_SEAT, options, next));
+        ++next;
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_SearchMove)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_GetCardTexture(benchmark::State& st) {
+    const CardPile deck = makeDeck();
+    for (auto _ : st) {
+        int sum = 0;
+        for (Card card : deck) sum += getCardTexture(card);
+        benchmark::DoNotOptimize(sum);
+    }
+    st.SetItemsProcessed(st.iterations() * DECK_SIZE);
+}
+BENCHMARK(BM_GetCardTexture);
+
+BENCHMARK_MAIN();
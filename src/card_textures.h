@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/card.h"
+
+#include <cstdint>
+#include <string>
+
+// Layers of the card texture array: one per face in face order, then the back.
+const int CARD_BACK_LAYER = uno::FACE_COUNT;
+const int CARD_LAYER_COUNT = uno::FACE_COUNT + 1;
+
+struct CardLayerTable {
+    uint8_t layer[uno::CARD_ID_LIMIT];
+};
+
+constexpr CardLayerTable buildCardLayerTable() {
+    CardLayerTable table = {};
+    for (int id = 0; id < uno::CARD_ID_LIMIT; ++id) {
+        table.layer[id] = (uint8_t)uno::Card{ (uint8_t)id }.face();
+    }
+    return table;
+}
+
+inline constexpr CardLayerTable CARD_LAYERS = buildCardLayerTable();
+
+// Layer of the card's face in the card texture array.
+inline int getCardTexture(uno::Card c) {
+    return CARD_LAYERS.layer[c.id];
+}
+
+inline std::string cardColorToString(uno::CardColor c) {
+    switch(c) {
+        case uno::RED: return "red";
+        case uno::GREEN: return "green";
+        case uno::BLUE: return "blue";
+        case uno::YELLOW: return "yellow";
+        default: return "";
+    }
+}
+
+// Image file for a texture array layer. Only used while loading.
+inline std::string cardLayerPath(int layer) {
+    if (layer == CARD_BACK_LAYER) return "textures/card_back/back.png";
+    if (layer == uno::FACE_COUNT - 2) return "textures/wild/wild.png";
+    if (layer == uno::FACE_COUNT - 1) return "textures/wild/wild_draw.png";
+
+    int symbol = layer / 4;
+    std::string colorStr = cardColorToString((uno::CardColor)(layer % 4));
+    std::string prefix = "textures/" + colorStr + "/";
+    switch (symbol) {
+        case uno::SYMBOL_SKIP: return prefix + "block_" + colorStr + ".png";
+        case uno::SYMBOL_SKIP + 1: return prefix + "inverse_" + colorStr + ".png";
+        case uno::SYMBOL_SKIP + 2: return prefix + "2plus_" + colorStr + ".png";
+        default: return prefix + std::to_string(symbol) + "_" + colorStr + ".png";
+    }
+}
@@ -0,0 +1,105 @@
+#include "table_layout.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Quad {
+    float left, bottom, right, top;
+    Hit hit;
+};
+
+// A quad as the vertex shader places it: every corner of `verts` (stride
+// floats apart) scaled and offset, as in aPos * scale + offset.
+Quad placeQuad(const float* verts, size_t corners, size_t stride, float scaleX, float scaleY,
+               float offsetX, float offsetY, Hit hit) {
+    Quad quad = { INFINITY, INFINITY, -INFINITY, -INFINITY, hit };
+    for (size_t i = 0; i < corners; ++i) {
+        float x = verts[i * stride] * scaleX + offsetX, y = verts[i * stride + 1] * scaleY + offsetY;
+        quad.left = min(quad.left, x);
+        quad.right = max(quad.right, x);
+        quad.bottom = min(quad.bottom, y);
+        quad.top = max(quad.top, y);
+    }
+    return quad;
+}
+
+// The player's side of the table in the order the frame draws it: the
+// piles, the hand row by row from the back, each row left to right, then
+// the wild color buttons over everything.
+vector<Quad> drawnQuads(const HandSlots& hand, float originX) {
+    vector<Quad> quads;
+    auto card = [&](float x, float y, Hit hit) {
+        quads.push_back(placeQuad(CARD_VERTS, 4, 4, CARD_W, CARD_H, x, y, hit));
+    };
+    card(DRAW_PILE_X, PILE_Y, { HIT_DRAW_PILE, 0 });
+    card(DISCARD_X, PILE_Y, { HIT_NOTHING, 0 });
+    for (size_t r = hand.rows.size(); r-- > 0; ) {
+        for (size_t i = hand.rows[r].first; i < hand.rows[r].first + hand.rows[r].count; ++i) {
+            card(hand.slotX[i] + originX, hand.slotY[i], { HIT_HAND_CARD, (int)i });
+        }
+    }
+    for (const ColorButton& button : COLOR_BUTTONS) {
+        quads.push_back(placeQuad(UI_VERTS, 6, 2, COLOR_BUTTON_SIZE, COLOR_BUTTON_SIZE, button.x, COLOR_BUTTON_Y,
+                                  { HIT_COLOR_BUTTON, button.color }));
+    }
+    return quads;
+}
+
+// The topmost quad under (x, y). False when the point lies within float
+// rounding of an edge, where the pick may go either way.
+bool topmostAt(const vector<Quad>& quads, float x, float y, Hit& hit) {
+    const float EDGE = 1e-5f;
+    for (size_t i = quads.size(); i-- > 0; ) {
+        const Quad& quad = quads[i];
+        float inside = min(min(x - quad.left, quad.right - x), min(y - quad.bottom, quad.top - y));
+        if (abs(inside) < EDGE) return false;
+        if (inside > 0.0f) {
+            hit = quad.hit;
+            return true;
+        }
+    }
+    hit = { HIT_NOTHING, 0 };
+    return true;
+}
+
+}
+
+// Compares pickOnTable() with the topmost drawn quad over a grid of points
+// covering the player's half of the table, for every hand size.
+int main() {
+    const int STEPS = 400;
+    const float STEP = 2.0f / STEPS;
+    long points = 0, mismatches = 0;
+
+    for (size_t count = 1; count <= uno::DECK_SIZE; ++count) {
+        HandSlots hand = { -0.7f, 1.0f };
+        hand.spacing = handSpacing(count);
+        for (size_t i = 0; i < count; ++i) placeSlot(hand, i);
+        placeRows(hand, count);
+        float originX = handOriginX(count, hand.spacing);
+        vector<Quad> quads = drawnQuads(hand, originX);
+
+        for (int row = 0; row < STEPS * 3 / 4; ++row) {
+            for (int column = 0; column < STEPS; ++column) {
+                float x = -1.0f + (column + 0.5f) * STEP, y = -1.0f + (row + 0.5f) * STEP;
+                Hit expected;
+                if (!topmostAt(quads, x, y, expected)) continue;
+                ++points;
+                Hit hit = pickOnTable(hand, originX, x, y);
+                if (hit.kind != expected.kind || hit.index != expected.index) {
+                    if (mismatches++ < 10) {
+                        printf("mismatch: %zu cards at (%.4f, %.4f): picked %d/%d, drawn %d/%d\n", count, x, y,
+                               hit.kind, hit.index, expected.kind, expected.index);
+                    }
+                }
+            }
+        }
+    }
+    printf("%ld points, %ld mismatches\n", points, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
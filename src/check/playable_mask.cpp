@@ -0,0 +1,44 @@
+#include "core/card.h"
+
+#include <cstdio>
+
+using namespace std;
+using namespace uno;
+
+// Compares playableMask() with canPlay() card by card over random hands.
+// Built once per instruction set path (see CMakeLists.txt), each variant
+// linking its own copy of card.cpp.
+int main() {
+#if defined(UNO_CHECK_AVX2)
+    if (!__builtin_cpu_supports("avx2")) {
+        printf("skipped: this CPU has no AVX2\n");
+        return 77;
+    }
+#endif
+    const int HANDS = 200000;
+    const CardPile deck = makeDeck();
+    Xoshiro256 rng(1);
+    Card hand[80];
+    long mismatches = 0;
+
+    for (int h = 0; h < HANDS; ++h) {
+        size_t count = randomBelow(rng, 81);
+        for (size_t i = 0; i < count; ++i) hand[i] = deck[randomBelow(rng, DECK_SIZE)];
+        Card top = deck[randomBelow(rng, DECK_SIZE)];
+        CardColor color = (CardColor)randomBelow(rng, 4);
+
+        uint64_t expected = 0;
+        for (size_t i = 0; i < count && i < 64; ++i) {
+            if (canPlay(hand[i], top, color)) expected |= 1ull << i;
+        }
+        uint64_t mask = playableMask(hand, count, top, color);
+        if (mask != expected) {
+            if (mismatches++ < 10) {
+                printf("mismatch: %zu cards, top %d, color %d: %016llx, expected %016llx\n", count, top.id, color,
+                       (unsigned long long)mask, (unsigned long long)expected);
+            }
+        }
+    }
+    printf("%d hands, %ld mismatches\n", HANDS, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
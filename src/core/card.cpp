@@ -0,0 +1,95 @@
+#include "core/card.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace uno {
+
+CardPile makeDeck() {
+    CardPile deck;
+    for (int c = 0; c < 4; ++c) {
+        for (int n = 0; n <= 9; ++n) {
+            deck.push_back(makeCard((CardColor)c, NUMBER, n, 0));
+            if(n!=0) deck.push_back(makeCard((CardColor)c, NUMBER, n, 1));
+        }
+        for (int i = 0; i < 2; ++i) {
+            deck.push_back(makeCard((CardColor)c, SKIP, -1, i));
+            deck.push_back(makeCard((CardColor)c, REVERSE, -1, i));
+            deck.push_back(makeCard((CardColor)c, DRAW_TWO, -1, i));
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        deck.push_back(makeCard(NONE, WILD, -1, i));
+        deck.push_back(makeCard(NONE, WILD_DRAW_FOUR, -1, i));
+    }
+    return deck;
+}
+
+bool canPlay(Card card, Card top, CardColor activeColor) {
+    if (isWild(card)) return true;
+    if (card.color() == activeColor) return true;
+    if (card.symbol() == top.symbol()) return true;
+    return false;
+}
+
+// Decodes each id in registers: symbol = id >> 3, color = (id >> 1) & 3.
+// Byte shifts don't exist, so shift 16-bit lanes and mask off what crossed
+// in from the neighbouring byte. A wild's color bits are its copy index and
+// may match activeColor, which is harmless since wilds always match.
+uint64_t playableMask(const Card* cards, size_t count, Card top, CardColor activeColor) {
+    if (count > 64) count = 64;
+    uint64_t valid = count == 64 ? ~0ull : (1ull << count) - 1;
+
+#if defined(__AVX2__)
+    alignas(32) uint8_t ids[64] = {};
+    memcpy(ids, cards, count);
+    const __m256i symbolMask = _mm256_set1_epi8(0x1F);
+    const __m256i colorMask = _mm256_set1_epi8(0x03);
+    const __m256i lastColored = _mm256_set1_epi8(SYMBOL_WILD - 1);
+    const __m256i topSymbol = _mm256_set1_epi8((char)top.symbol());
+    const __m256i color = _mm256_set1_epi8((char)activeColor);
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < count; i += 32) {
+        __m256i v = _mm256_load_si256((const __m256i*)(ids + i));
+        __m256i symbol = _mm256_and_si256(_mm256_srli_epi16(v, 3), symbolMask);
+        __m256i cardColor = _mm256_and_si256(_mm256_srli_epi16(v, 1), colorMask);
+        __m256i match = _mm256_or_si256(_mm256_cmpgt_epi8(symbol, lastColored),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(cardColor, color), _mm256_cmpeq_epi8(symbol, topSymbol)));
+        mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(match) << i;
+    }
+    return mask & valid;
+#elif defined(__SSE2__) || defined(_M_X64)
+    alignas(16) uint8_t ids[64] = {};
+    memcpy(ids, cards, count);
+    const __m128i symbolMask = _mm_set1_epi8(0x1F);
+    const __m128i colorMask = _mm_set1_epi8(0x03);
+    const __m128i lastColored = _mm_set1_epi8(SYMBOL_WILD - 1);
+    const __m128i topSymbol = _mm_set1_epi8((char)top.symbol());
+    const __m128i color = _mm_set1_epi8((char)activeColor);
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < count; i += 16) {
+        __m128i v = _mm_load_si128((const __m128i*)(ids + i));
+        __m128i symbol = _mm_and_si128(_mm_srli_epi16(v, 3), symbolMask);
+        __m128i cardColor = _mm_and_si128(_mm_srli_epi16(v, 1), colorMask);
+        __m128i match = _mm_or_si128(_mm_cmpgt_epi8(symbol, lastColored),
+                        _mm_or_si128(_mm_cmpeq_epi8(cardColor, color), _mm_cmpeq_epi8(symbol, topSymbol)));
+        mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(match) << i;
+    }
+    return mask & valid;
+#else
+    uint64_t mask = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (canPlay(cards[i], top, activeColor)) mask |= 1ull << i;
+    }
+    return mask & valid;
+#endif
+}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core/random.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace uno {
+
+enum CardColor { RED, GREEN, BLUE, YELLOW, NONE };
+enum CardType { NUMBER, SKIP, REVERSE, DRAW_TWO, WILD, WILD_DRAW_FOUR };
+
+const int DECK_SIZE = 108;
+const int CARD_ID_LIMIT = 128;
+const int SYMBOL_COUNT = 15;
+const int FACE_COUNT = 54;
+
+// Symbols 0-9 are the numbers, then SKIP, REVERSE, DRAW_TWO, WILD, WILD_DRAW_FOUR.
+const int SYMBOL_SKIP = 10;
+const int SYMBOL_WILD = 13;
+
+// A physical card packed into 7 bits: symbol << 3 | color << 1 | copy.
+// Every card in the deck has its own id, so front ends can key per-card
+// state (position, animation) by it. Wilds have no color and use the low
+// three bits as a copy index instead. The color a wild was called as is
+// table state (GameState::activeColor), not part of the card.
+struct Card {
+    uint8_t id;
+
+    constexpr int symbol() const { return id >> 3; }
+    constexpr CardColor color() const { return symbol() >= SYMBOL_WILD ? NONE : (CardColor)((id >> 1) & 3); }
+    constexpr CardType type() const { return symbol() < SYMBOL_SKIP ? NUMBER : (CardType)(symbol() - SYMBOL_SKIP + 1); }
+    constexpr int number() const { return symbol() < SYMBOL_SKIP ? symbol() : -1; }
+
+    // Distinct card faces: 13 per color, then WILD and WILD_DRAW_FOUR.
+    constexpr int face() const { return symbol() >= SYMBOL_WILD ? 52 + symbol() - SYMBOL_WILD : symbol() * 4 + color(); }
+};
+
+constexpr Card makeCard(CardColor color, CardType type, int number, int copy) {
+    int symbol = type == NUMBER ? number : SYMBOL_SKIP + type - 1;
+    if (symbol >= SYMBOL_WILD) return { (uint8_t)(symbol << 3 | copy) };
+    return { (uint8_t)(symbol << 3 | color << 1 | copy) };
+}
+
+constexpr bool isWild(Card card) {
+    return card.symbol() >= SYMBOL_WILD;
+}
+
+// Fixed-capacity stack of cards. Every hand and pile is one of these, so a
+// whole GameState is a flat, trivially copyable block with no heap behind it.
+class CardPile {
+    public:
+    Card cards[DECK_SIZE];
+    uint8_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    Card& operator[](size_t i) { return cards[i]; }
+    Card operator[](size_t i) const { return cards[i]; }
+    Card& back() { return cards[count - 1]; }
+    Card back() const { return cards[count - 1]; }
+
+    Card* begin() { return cards; }
+    Card* end() { return cards + count; }
+    const Card* begin() const { return cards; }
+    const Card* end() const { return cards + count; }
+
+    void push_back(Card card) { cards[count++] = card; }
+    void pop_back() { --count; }
+};
+
+CardPile makeDeck();
+bool canPlay(Card card, Card top, CardColor activeColor);
+
+// canPlay() for up to 64 cards at once: bit i is set when cards[i] is
+// playable. Cards past the 64th are ignored. Uses AVX2 or SSE2 compares
+// when the build targets them, a scalar loop otherwise.
+uint64_t playableMask(const Card* cards, size_t count, Card top, CardColor activeColor);
+
+// Fisher-Yates with a caller-owned, explicitly seeded generator, so the same
+// seed deals the same deck everywhere.
+template <class Rng>
+void shuffle(CardPile& pile, Rng& rng) {
+    for (uint32_t i = (uint32_t)pile.size(); i > 1; --i) {
+        std::swap(pile[i - 1], pile[randomBelow(rng, i)]);
+    }
+}
+
+}
@@ -0,0 +1,139 @@
+#include "core/game_state.h"
+
+using namespace std;
+
+namespace uno {
+
+void GameState::deal(const CardPile& deck, uint64_t seed, int seats) {
+    seatCount = seats;
+    direction = 1;
+    for (int seat = 0; seat < seatCount; ++seat) hands.clear(seat);
+    discardPile.clear();
+    drawPile = deck;
+
+    for (int i = 0; i < STARTING_HAND; ++i) {
+        for (int seat = 0; seat < seatCount; ++seat) {
+            hands.push_back(seat, drawPile.back());
+            drawPile.pop_back();
+        }
+    }
+    discardPile.push_back(drawPile.back());
+    drawPile.pop_back();
+    activeColor = top().color();
+
+    turn = PLAYER_SEAT;
+    winner = -1;
+    turnCount = 0;
+    rng.seed(seed);
+}
+
+void GameState::playCard(int seat, size_t index, CardColor chosenColor) {
+    Card card = hands.cards[seat][index];
+    discardPile.push_back(card);
+    hands.erase(seat, index);
+    activeColor = isWild(card) ? chosenColor : card.color();
+}
+
+void GameState::chooseColor(CardColor color) {
+    activeColor = color;
+}
+
+void GameState::resolvePlay(int seat) {
+    Card played = discardPile.back();
+    if (played.type() == REVERSE) direction = -direction;
+    int next = nextSeat(seat);
+
+    int penalty = 0;
+    if (played.type() == DRAW_TWO) penalty = 2;
+    else if (played.type() == WILD_DRAW_FOUR) penalty = 4;
+    for (int i = 0; i < penalty; ++i) {
+        if (!drawCard(next)) break;
+    }
+
+    if (hands.count[seat] == 0) {
+        winner = seat;
+        return;
+    }
+
+    // Passing the turn from `next` skips it.
+    if (played.type() == SKIP || (played.type() == REVERSE && seatCount == 2)) turn = next;
+    nextTurn();
+}
+
+// False only when every card but the top discard is in someone's hand.
+// The pile is refilled as soon as it runs out, so it always shows a card
+// while there is one to draw.
+bool GameState::drawCard(int seat) {
+    if (drawPile.empty()) recycleDiscards();
+    if (drawPile.empty()) return false;
+    hands.push_back(seat, drawPile.back());
+    drawPile.pop_back();
+    if (drawPile.empty()) recycleDiscards();
+    return true;
+}
+
+// Shuffles everything under the top discard back into the empty draw pile.
+// Both piles are fixed arrays, so this moves cards and allocates nothing.
+// A wild needs no reset: the color it was called as is activeColor, which
+// belongs to the top card that stays behind.
+void GameState::recycleDiscards() {
+    if (discardPile.size() <= 1) return;
+    Card top = discardPile.back();
+    discardPile.pop_back();
+    for (Card card : discardPile) drawPile.push_back(card);
+    discardPile.clear();
+    discardPile.push_back(top);
+    shuffle(drawPile, rng);
+}
+
+void GameState::nextTurn() {
+    turn = nextSeat(turn);
+    ++turnCount;
+}
+
+Move chooseAiMove(const GameState& state, int seat) {
+    uint64_t playable = state.playableFaces(seat);
+    if (!playable) return { -1, NONE };
+
+    // The first playable card in hand order.
+    HandView hand = state.hands[seat];
+    int index = 0;
+    while (!(playable >> hand[index].face() & 1)) ++index;
+    if (!isWild(hand[index])) return { index, NONE };
+
+    const uint8_t* colorCount = state.hands.colorCount[seat];
+    int maxCount = 0;
+    int maxColor = 0;
+    for (int c = 0; c < 4; ++c) {
+        if (colorCount[c] > maxCount) {
+            maxCount = colorCount[c];
+            maxColor = c;
+        }
+    }
+    return { index, (CardColor)maxColor };
+}
+
+// Plays a whole move for the seat to act, effects included.
+void applyMove(GameState& state, Move move) {
+    int seat = state.turn;
+    if (move.index != -1) {
+        state.playCard(seat, move.index, move.color);
+        state.resolvePlay(seat);
+    } else {
+        state.drawCard(seat);
+        state.nextTurn();
+    }
+}
+
+void takeAiTurn(GameState& state) {
+    applyMove(state, chooseAiMove(state, state.turn));
+}
+
+int playGame(GameState& state, long maxTurns) {
+    while (!state.isOver() && state.turnCount < maxTurns) {
+        takeAiTurn(state);
+    }
+    return state.winner;
+}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/card.h"
+#include "core/hand.h"
+
+#include <cstddef>
+
+namespace uno {
+
+const int MIN_SEATS = 2;
+const int PLAYER_SEAT = 0;
+const int AI_SEAT = 1;
+const int STARTING_HAND = 7;
+
+// A move for the seat to act: play hand[index] (naming `color` for wilds),
+// or draw a card when index is -1.
+struct Move {
+    int index;
+    CardColor color;
+};
+
+// The whole table, free of any timing or rendering. A turn is played in two
+// steps so a front end can animate in between: playCard() moves the card onto
+// the discard pile, resolvePlay() applies its effect and passes the turn.
+//
+// Seats 0..seatCount-1 play in turn order `direction` (+1 or -1), which
+// REVERSE flips. With two seats REVERSE acts as SKIP, as in the printed
+// rules. DRAW_TWO and WILD_DRAW_FOUR make the next seat draw, and then it
+// is that seat's turn.
+class GameState {
+    public:
+    Hands hands;
+    CardPile drawPile;
+    CardPile discardPile;
+
+    int seatCount = MIN_SEATS;
+    int direction = 1;
+    CardColor activeColor = NONE;
+    int turn = PLAYER_SEAT;
+    int winner = -1;
+    long turnCount = 0;
+    Xoshiro256 rng;     // reshuffles recycled discards
+
+    void deal(const CardPile& deck, uint64_t seed, int seats = MIN_SEATS);
+
+    Card top() const { return discardPile.back(); }
+    uint64_t playableFaces(int seat) const { return hands.playable(seat, top(), activeColor); }
+    bool isOver() const { return winner >= 0; }
+    int nextSeat(int seat) const {
+        int next = seat + direction;
+        return next < 0 ? next + seatCount : next >= seatCount ? next - seatCount : next;
+    }
+
+    void playCard(int seat, std::size_t index, CardColor chosenColor = NONE);
+    void chooseColor(CardColor color);
+    void resolvePlay(int seat);
+    bool drawCard(int seat);
+    void recycleDiscards();
+    void nextTurn();
+};
+
+Move chooseAiMove(const GameState& state, int seat);
+void applyMove(GameState& state, Move move);
+void takeAiTurn(GameState& state);
+int playGame(GameState& state, long maxTurns);
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "core/card.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace uno {
+
+const int FIRST_WILD_FACE = 52;
+
+inline int lowestFace(uint64_t faces) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, faces);
+    return (int)index;
+#else
+    return __builtin_ctzll(faces);
+#endif
+}
+
+inline int countFaces(uint64_t faces) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(faces);
+#else
+    return __builtin_popcountll(faces);
+#endif
+}
+
+// Bit f of each mask is set when face f belongs to the group.
+struct FaceMasks {
+    uint64_t color[NONE + 1];
+    uint64_t symbol[SYMBOL_COUNT];
+    uint64_t wild;
+};
+
+constexpr FaceMasks buildFaceMasks() {
+    FaceMasks masks = {};
+    for (int s = 0; s < SYMBOL_WILD; ++s) {
+        for (int c = 0; c < 4; ++c) {
+            uint64_t bit = 1ull << (s * 4 + c);
+            masks.color[c] |= bit;
+            masks.symbol[s] |= bit;
+        }
+    }
+    for (int s = SYMBOL_WILD; s < SYMBOL_COUNT; ++s) {
+        masks.symbol[s] = 1ull << (FIRST_WILD_FACE + s - SYMBOL_WILD);
+        masks.wild |= masks.symbol[s];
+    }
+    return masks;
+}
+
+inline constexpr FaceMasks FACE_MASKS = buildFaceMasks();
+
+// Every face that may be played on `top` once `activeColor` is in force.
+inline uint64_t playableFaceMask(Card top, CardColor activeColor) {
+    return FACE_MASKS.color[activeColor] | FACE_MASKS.symbol[top.symbol()] | FACE_MASKS.wild;
+}
+
+const int MAX_SEATS = 10;
+
+// One seat's cards in play order, read only.
+class HandView {
+    public:
+    const Card* cards;
+    size_t count;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Card operator[](size_t i) const { return cards[i]; }
+    Card back() const { return cards[count - 1]; }
+    const Card* begin() const { return cards; }
+    const Card* end() const { return cards + count; }
+
+    // Index of the first card with the given face, or -1.
+    int find(int face) const {
+        for (size_t i = 0; i < count; ++i) {
+            if (cards[i].face() == face) return (int)i;
+        }
+        return -1;
+    }
+};
+
+// Every seat's hand as a structure of arrays indexed by seat, so a table of
+// N seats is N entries per array rather than N objects. Besides the cards
+// in play order each seat keeps a running summary: the set of faces held and
+// how many cards of each face and color. Which cards a seat can play is then
+// one AND against playableFaceMask(), whatever the hand size.
+class Hands {
+    public:
+    uint64_t faces[MAX_SEATS] = {};
+    uint8_t count[MAX_SEATS] = {};
+    uint8_t colorCount[MAX_SEATS][NONE + 1] = {};
+    uint8_t faceCount[MAX_SEATS][FACE_COUNT] = {};
+    Card cards[MAX_SEATS][DECK_SIZE];
+
+    HandView operator[](int seat) const { return { cards[seat], count[seat] }; }
+
+    void clear(int seat) {
+        count[seat] = 0;
+        faces[seat] = 0;
+        std::fill(faceCount[seat], faceCount[seat] + FACE_COUNT, 0);
+        std::fill(colorCount[seat], colorCount[seat] + NONE + 1, 0);
+    }
+
+    void push_back(int seat, Card card) {
+        cards[seat][count[seat]++] = card;
+        int face = card.face();
+        faceCount[seat][face]++;
+        colorCount[seat][card.color()]++;
+        faces[seat] |= 1ull << face;
+    }
+
+    // Keeps the order of the remaining cards, which the hand layout relies on.
+    void erase(int seat, size_t i) {
+        Card card = cards[seat][i];
+        std::copy(cards[seat] + i + 1, cards[seat] + count[seat], cards[seat] + i);
+        count[seat]--;
+        int face = card.face();
+        colorCount[seat][card.color()]--;
+        if (--faceCount[seat][face] == 0) faces[seat] &= ~(1ull << face);
+    }
+
+    uint64_t playable(int seat, Card top, CardColor activeColor) const {
+        return faces[seat] & playableFaceMask(top, activeColor);
+    }
+};
+
+}
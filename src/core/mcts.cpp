@@ -0,0 +1,345 @@
+#include "core/mcts.h"
+
+#include "core/playout.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+
+namespace uno {
+
+// Stop growing the tree past this many nodes (~56 MB); playouts carry on
+// from the existing leaves.
+const size_t MAX_NODES = 1 << 21;
+
+// Most visits a new node takes over from the transposition table, so one
+// well-explored transposition guides the search without drowning it. Only
+// entries with at least this many visits seed a node: a thinner entry's
+// mean is mostly the noise of its few playouts.
+const uint32_t TABLE_PRIOR_VISITS = 16;
+
+static int nthFace(uint64_t faces, int n) {
+    for (; n > 0; --n) faces &= faces - 1;
+    return lowestFace(faces);
+}
+
+uint64_t legalActions(const GameState& state, int seat) {
+    uint64_t faces = state.playableFaces(seat);
+    uint64_t actions = faces & ~FACE_MASKS.wild;
+    if (faces >> FIRST_WILD_FACE & 1) actions |= 0xFull << ACTION_WILD;
+    if (faces >> (FIRST_WILD_FACE + 1) & 1) actions |= 0xFull << (ACTION_WILD + 4);
+    // Drawing is always allowed, but passing on an empty pile only when stuck.
+    if (!state.drawPile.empty() || !actions) actions |= 1ull << ACTION_DRAW;
+    return actions;
+}
+
+Move actionToMove(const GameState& state, int seat, int action) {
+    if (action == ACTION_DRAW) return { -1, NONE };
+    if (action < ACTION_WILD) return { state.hands[seat].find(action), NONE };
+    int face = FIRST_WILD_FACE + (action - ACTION_WILD) / 4;
+    return { state.hands[seat].find(face), (CardColor)((action - ACTION_WILD) % 4) };
+}
+
+void applyAction(GameState& state, int action) {
+    applyMove(state, actionToMove(state, state.turn, action));
+}
+
+int cardAction(Card card, CardColor calledColor) {
+    if (!isWild(card)) return card.face();
+    return ACTION_WILD + (card.face() - FIRST_WILD_FACE) * 4 + calledColor;
+}
+
+Search::Search(const GameState& state, int seat, uint64_t seed)
+    : observer(seat), rng(seed) {
+    Node rootNode;
+    rootNode.parent = -1;
+    rootNode.action = 0;
+    rootNode.seat = -1;
+    nodes.push_back(rootNode);
+    setRoot(state);
+}
+
+void Search::setRoot(const GameState& state) {
+    root = state;
+
+    bool seen[CARD_ID_LIMIT] = {};
+    for (Card card : state.hands[observer]) seen[card.id] = true;
+    for (Card card : state.discardPile) seen[card.id] = true;
+    unseen.clear();
+    for (Card card : makeDeck()) {
+        if (!seen[card.id]) unseen.push_back(card);
+    }
+}
+
+void Search::advance(int action, const GameState& state) {
+    setRoot(state);
+
+    int from = -1;
+    for (int c = nodes[0].firstChild; c != -1; c = nodes[c].nextSibling) {
+        if (nodes[c].action == action) from = c;
+    }
+
+    // Copy the subtree out depth first, so every parent lands before its
+    // children, and drop the rest.
+    vector<Node> kept;
+    if (from != -1) {
+        vector<pair<int, int>> pending = { { from, -1 } };
+        while (!pending.empty()) {
+            auto [old, parent] = pending.back();
+            pending.pop_back();
+
+            Node node = nodes[old];
+            node.parent = parent;
+            node.firstChild = -1;
+            node.nextSibling = parent >= 0 ? kept[parent].firstChild : -1;
+            kept.push_back(node);
+            int index = (int)kept.size() - 1;
+            if (parent >= 0) kept[parent].firstChild = index;
+
+            for (int c = nodes[old].firstChild; c != -1; c = nodes[c].nextSibling) {
+                pending.push_back({ c, index });
+            }
+        }
+        kept[0].seat = -1;
+    } else {
+        Node rootNode;
+        rootNode.parent = -1;
+        rootNode.action = 0;
+        rootNode.seat = -1;
+        kept.push_back(rootNode);
+    }
+    nodes.swap(kept);
+}
+
+// Deals the cards `observer` cannot see into the other hands and the draw
+// pile at random, keeping every count the observer knows.
+void Search::determinize(GameState& sample) {
+    sample = root;
+    sample.rng.seed(rng());
+    shuffle(unseen, rng);
+
+    size_t next = 0;
+    for (int seat = 0; seat < sample.seatCount; ++seat) {
+        if (seat == observer) continue;
+        size_t count = sample.hands.count[seat];
+        sample.hands.clear(seat);
+        for (size_t i = 0; i < count; ++i) sample.hands.push_back(seat, unseen[next++]);
+    }
+    sample.drawPile.clear();
+    while (next < unseen.size()) sample.drawPile.push_back(unseen[next++]);
+}
+
+int Search::addChild(int parent, int action, int seat) {
+    Node child;
+    child.parent = parent;
+    child.action = (uint8_t)action;
+    child.seat = (int8_t)seat;
+    child.nextSibling = nodes[parent].firstChild;
+    nodes.push_back(child);
+    nodes[parent].firstChild = (int)nodes.size() - 1;
+    return nodes[parent].firstChild;
+}
+
+void Search::iterate(const SearchOptions& options) {
+    GameState sample;
+    determinize(sample);
+    path.clear();
+
+    int node = 0;
+    while (!sample.isOver()) {
+        uint64_t legal = legalActions(sample, sample.turn);
+        uint64_t tried = 0;
+        int best = -1;
+        double bestScore = -1.0;
+
+        for (int c = nodes[node].firstChild; c != -1; c = nodes[c].nextSibling) {
+            Node& child = nodes[c];
+            if (!(legal >> child.action & 1)) continue;
+            tried |= 1ull << child.action;
+            child.avails++;
+            double score = child.reward / child.visits +
+                           options.exploration * sqrt(log((double)child.avails) / child.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+
+        uint64_t untried = legal & ~tried;
+        if (untried && nodes.size() < MAX_NODES) {
+            int action = nthFace(untried, randomBelow(rng, countFaces(untried)));
+            int seat = sample.turn;
+            applyAction(sample, action);
+            node = addChild(node, action, seat);
+            if (options.table) {
+                uint64_t key = hashPosition(sample, observer, seat);
+                seedFromTable(nodes[node], key, *options.table);
+                path.push_back({ node, key });
+            }
+            break;
+        }
+        if (best < 0) break;
+        applyAction(sample, nodes[best].action);
+        node = best;
+        if (options.table) path.push_back({ node, hashPosition(sample, observer, nodes[node].seat) });
+    }
+
+    int winner = sample.isOver() ? sample.winner : rollout(sample, options);
+    for (int n = node; n != -1; n = nodes[n].parent) {
+        Node& visited = nodes[n];
+        visited.visits++;
+        if (winner < 0) visited.reward += 1.0f / sample.seatCount;
+        else if (winner == visited.seat) visited.reward += 1.0f;
+    }
+    // A seeded node writes back only once its own playouts outweigh the
+    // prior, so the table never learns its own copy as new evidence.
+    for (const PathStep& step : path) {
+        const Node& stored = nodes[step.node];
+        if (stored.visits - stored.prior > stored.prior) options.table->store(step.key, { stored.visits, stored.reward });
+    }
+}
+
+// Starts a new node from what other lines, trees or earlier searches
+// learned about the same position.
+void Search::seedFromTable(Node& node, uint64_t key, const TranspositionTable& table) {
+    totals.tableProbes++;
+    TableEntry entry;
+    if (!table.probe(key, entry) || entry.visits < TABLE_PRIOR_VISITS) return;
+    totals.tableHits++;
+    node.visits = node.prior = TABLE_PRIOR_VISITS;
+    node.reward = entry.reward * node.visits / entry.visits;
+}
+
+// Random playout on the compact Playout state: any playable card with equal
+// probability, wilds called as the hand's majority color, drawing only when
+// nothing can be played.
+int Search::rollout(const GameState& sample, const SearchOptions& options) {
+    Playout playout;
+    loadPlayout(playout, sample);
+    return runPlayout(playout, rng, (uint32_t)options.rolloutTurns);
+}
+
+void Search::run(const SearchOptions& options) {
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&] { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+
+    long done = 0;
+    for (;;) {
+        if (options.maxPlayouts > 0 && done >= options.maxPlayouts) break;
+        if ((done & 31) == 0) {
+            if (options.timeBudget > 0.0 && elapsed() >= options.timeBudget) break;
+            if (options.stop && options.stop->load(memory_order_relaxed)) break;
+        }
+        if (options.maxPlayouts <= 0 && options.timeBudget <= 0.0 && !options.stop) break;
+        if (options.nodeLimit > 0 && nodes.size() >= options.nodeLimit) break;
+        iterate(options);
+        ++done;
+    }
+    totals.playouts += done;
+    totals.seconds += elapsed();
+}
+
+int Search::bestAction() const {
+    uint64_t legal = legalActions(root, observer);
+    int best = -1;
+    uint32_t bestVisits = 0;
+    for (int c = nodes[0].firstChild; c != -1; c = nodes[c].nextSibling) {
+        if (!(legal >> nodes[c].action & 1)) continue;
+        if (nodes[c].visits - nodes[c].prior > bestVisits) {
+            bestVisits = nodes[c].visits - nodes[c].prior;
+            best = nodes[c].action;
+        }
+    }
+    return best;
+}
+
+Move Search::bestMove() const {
+    int action = bestAction();
+    if (action < 0) return chooseAiMove(root, observer);
+    return actionToMove(root, observer, action);
+}
+
+void Search::rootVisits(uint32_t visits[ACTION_COUNT]) const {
+    fill(visits, visits + ACTION_COUNT, 0);
+    for (int c = nodes[0].firstChild; c != -1; c = nodes[c].nextSibling) {
+        visits[nodes[c].action] += nodes[c].visits - nodes[c].prior;
+    }
+}
+
+ParallelSearch::ParallelSearch(const GameState& state, int seat, int threads, uint64_t seed)
+    : root(state), observer(seat) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    searches.reserve(threads);
+    for (int i = 0; i < threads; ++i) searches.emplace_back(state, seat, streamSeed(seed, i));
+}
+
+void ParallelSearch::run(const SearchOptions& options) {
+    vector<thread> workers;
+    for (size_t i = 1; i < searches.size(); ++i) {
+        workers.emplace_back([this, &options, i] { searches[i].run(options); });
+    }
+    searches[0].run(options);
+    for (auto& worker : workers) worker.join();
+}
+
+Move ParallelSearch::bestMove() const {
+    uint64_t legal = legalActions(root, observer);
+    uint32_t total[ACTION_COUNT] = {};
+    for (const Search& search : searches) {
+        uint32_t visits[ACTION_COUNT];
+        search.rootVisits(visits);
+        for (int a = 0; a < ACTION_COUNT; ++a) {
+            if (legal >> a & 1) total[a] += visits[a];
+        }
+    }
+    int best = (int)(max_element(total, total + ACTION_COUNT) - total);
+    if (total[best] == 0) return chooseAiMove(root, observer);
+    return actionToMove(root, observer, best);
+}
+
+void ParallelSearch::advance(int action, const GameState& state) {
+    root = state;
+    vector<thread> workers;
+    for (size_t i = 1; i < searches.size(); ++i) {
+        workers.emplace_back([this, action, &state, i] { searches[i].advance(action, state); });
+    }
+    searches[0].advance(action, state);
+    for (auto& worker : workers) worker.join();
+}
+
+// Playouts add up across threads; the threads run side by side, so the
+// time is the longest of them.
+SearchStats ParallelSearch::stats() const {
+    SearchStats merged;
+    for (const Search& search : searches) {
+        merged.playouts += search.stats().playouts;
+        merged.seconds = max(merged.seconds, search.stats().seconds);
+        merged.tableProbes += search.stats().tableProbes;
+        merged.tableHits += search.stats().tableHits;
+    }
+    return merged;
+}
+
+long ParallelSearch::rootPlayouts() const {
+    long playouts = 0;
+    for (const Search& search : searches) playouts += search.rootPlayouts();
+    return playouts;
+}
+
+Move searchMove(const GameState& state, int seat, const SearchOptions& options, uint64_t seed, SearchStats* stats) {
+    if (options.threads == 1) {
+        Search search(state, seat, seed);
+        search.run(options);
+        if (stats) *stats = search.stats();
+        return search.bestMove();
+    }
+
+    ParallelSearch search(state, seat, options.threads, seed);
+    search.run(options);
+    if (stats) *stats = search.stats();
+    return search.bestMove();
+}
+
+}
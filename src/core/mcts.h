@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core/game_state.h"
+#include "core/transposition.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace uno {
+
+// Search actions: a non-wild face 0-51 is played as itself, each wild face
+// is split into one action per called color, and the last action draws.
+const int ACTION_WILD = FIRST_WILD_FACE;
+const int ACTION_DRAW = ACTION_WILD + 8;
+const int ACTION_COUNT = ACTION_DRAW + 1;
+
+uint64_t legalActions(const GameState& state, int seat);
+Move actionToMove(const GameState& state, int seat, int action);
+void applyAction(GameState& state, int action);
+int cardAction(Card card, CardColor calledColor);
+
+struct SearchOptions {
+    double timeBudget = 1.0;      // seconds per call to run(), 0 = no time limit
+    long maxPlayouts = 0;         // playouts per call to run(), 0 = no limit
+    long rolloutTurns = 400;      // a rollout still running after this many turns is scored as a tie
+    double exploration = 0.7;
+    int threads = 1;              // searchMove() only: independent trees searched in parallel, 0 = one per core
+    std::size_t nodeLimit = 0;    // run() returns once the tree holds this many nodes, 0 = no limit
+    const std::atomic<bool>* stop = nullptr;  // run() returns soon after this is set
+    TranspositionTable* table = nullptr;       // shared statistics for new nodes, may outlive the search
+};
+
+struct SearchStats {
+    long playouts = 0;
+    double seconds = 0.0;
+    long tableProbes = 0;
+    long tableHits = 0;
+
+    double playoutsPerSecond() const { return seconds > 0.0 ? playouts / seconds : 0.0; }
+    double tableHitRate() const { return tableProbes > 0 ? (double)tableHits / tableProbes : 0.0; }
+};
+
+// Single-observer Information-Set MCTS (Cowling, Powley & Whitehouse 2012)
+// from the point of view of `seat`. Each playout samples the hidden cards
+// (the other hands and the draw pile order) consistently with what `seat`
+// can see, then walks one shared tree whose edges are actions, choosing
+// only among actions legal in that sample. run() can be called repeatedly
+// to keep growing the same tree, and advance() carries it over to the next
+// position once a move has been made.
+class Search {
+    public:
+    Search(const GameState& state, int seat, uint64_t seed);
+
+    void run(const SearchOptions& options);
+    // The most visited root action that is legal in the root position,
+    // counting only the tree's own visits, not those seeded from the table. A
+    // re-rooted tree can hold children tried in samples that turned out
+    // wrong, such as a card the observer had not drawn yet.
+    int bestAction() const;
+    Move bestMove() const;
+
+    // Own visit count of each action at the root, indexed by action.
+    void rootVisits(uint32_t visits[ACTION_COUNT]) const;
+
+    // Re-roots the tree at the subtree of `action`, played from the current
+    // root to reach `state`, keeping its statistics. Starts afresh if the
+    // action was never tried.
+    void advance(int action, const GameState& state);
+    long rootPlayouts() const { return nodes[0].visits; }
+
+    const SearchStats& stats() const { return totals; }
+
+    private:
+    struct Node {
+        int parent;
+        int firstChild = -1;
+        int nextSibling = -1;
+        uint8_t action;
+        int8_t seat;             // who took `action` to reach this node
+        uint16_t prior = 0;      // of the visits, those seeded from the table
+        uint32_t visits = 0;
+        uint32_t avails = 0;
+        float reward = 0.0f;     // summed from `seat`'s point of view
+    };
+
+    struct PathStep {
+        int node;
+        uint64_t key;
+    };
+
+    void determinize(GameState& sample);
+    void iterate(const SearchOptions& options);
+    int rollout(const GameState& sample, const SearchOptions& options);
+    int addChild(int parent, int action, int seat);
+    void setRoot(const GameState& state);
+    void seedFromTable(Node& node, uint64_t key, const TranspositionTable& table);
+
+    GameState root;
+    int observer;
+    std::vector<Node> nodes;
+    std::vector<PathStep> path;  // nodes below the root this playout, with their table keys
+    CardPile unseen;
+    Xoshiro256 rng;
+    SearchStats totals;
+};
+
+// Root parallelisation: one Search per thread, each growing its own tree from
+// its own seed, with the root visit counts summed per action to pick the
+// move. The trees share nothing, so there are no locks and no virtual loss,
+// and the playouts per move scale with the thread count.
+class ParallelSearch {
+    public:
+    ParallelSearch(const GameState& state, int seat, int threads, uint64_t seed);
+
+    void run(const SearchOptions& options);
+    Move bestMove() const;
+    // Re-roots every tree, each on its own thread.
+    void advance(int action, const GameState& state);
+
+    SearchStats stats() const;
+    long rootPlayouts() const;
+    int threadCount() const { return (int)searches.size(); }
+
+    private:
+    GameState root;
+    int observer;
+    std::vector<Search> searches;
+};
+
+// A one-off decision within options.timeBudget on options.threads threads.
+Move searchMove(const GameState& state, int seat, const SearchOptions& options, uint64_t seed, SearchStats* stats = nullptr);
+
+}
@@ -0,0 +1,29 @@
+#include "core/playout.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace uno {
+
+void loadPlayout(Playout& playout, const GameState& state) {
+    const Hands& hands = state.hands;
+    for (int seat = 0; seat < state.seatCount; ++seat) {
+        playout.faces[seat] = hands.faces[seat];
+        copy(hands.faceCount[seat], hands.faceCount[seat] + FACE_COUNT, playout.faceCount[seat]);
+        copy(hands.colorCount[seat], hands.colorCount[seat] + NONE + 1, playout.colorCount[seat]);
+        playout.handSize[seat] = hands.count[seat];
+    }
+    playout.pileSize = (uint8_t)state.drawPile.size();
+    for (size_t i = 0; i < state.drawPile.size(); ++i) playout.pile[i] = (uint8_t)state.drawPile[i].face();
+    playout.discardSize = (uint8_t)state.discardPile.size();
+    for (size_t i = 0; i < state.discardPile.size(); ++i) playout.discard[i] = (uint8_t)state.discardPile[i].face();
+    playout.topSymbol = (uint8_t)state.top().symbol();
+    playout.activeColor = (uint8_t)state.activeColor;
+    playout.turn = (uint8_t)state.turn;
+    playout.seatCount = (uint8_t)state.seatCount;
+    playout.direction = (int8_t)state.direction;
+    playout.turns = 0;
+}
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/game_state.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace uno {
+
+struct FaceTable {
+    uint8_t symbol[FACE_COUNT];
+    uint8_t color[FACE_COUNT];
+};
+
+constexpr FaceTable buildFaceTable() {
+    FaceTable table = {};
+    for (int face = 0; face < FACE_COUNT; ++face) {
+        bool wild = face >= FIRST_WILD_FACE;
+        table.symbol[face] = (uint8_t)(wild ? SYMBOL_WILD + face - FIRST_WILD_FACE : face / 4);
+        table.color[face] = (uint8_t)(wild ? NONE : face % 4);
+    }
+    return table;
+}
+
+inline constexpr FaceTable FACES = buildFaceTable();
+
+// Everything a random playout needs and nothing else, laid out like Hands
+// as arrays over seats, on the stack. A playout never asks which copy of a
+// card is where, so hands are face multisets: playing or drawing a card is
+// a counter update and a bit flip, and both piles are arrays of faces used
+// from the back.
+struct Playout {
+    uint64_t faces[MAX_SEATS];
+    uint8_t faceCount[MAX_SEATS][FACE_COUNT];
+    uint8_t colorCount[MAX_SEATS][NONE + 1];
+    uint8_t handSize[MAX_SEATS];
+    uint8_t pile[DECK_SIZE];
+    uint8_t pileSize;
+    uint8_t discard[DECK_SIZE];
+    uint8_t discardSize;
+    uint8_t topSymbol;
+    uint8_t activeColor;
+    uint8_t turn;
+    uint8_t seatCount;
+    int8_t direction;
+    uint32_t turns;     // taken in this playout
+
+    int nextSeat(int seat) const {
+        int next = seat + direction;
+        return next < 0 ? next + seatCount : next >= seatCount ? next - seatCount : next;
+    }
+
+    void addCard(int seat, int face) {
+        faces[seat] |= 1ull << face;
+        faceCount[seat][face]++;
+        colorCount[seat][FACES.color[face]]++;
+        handSize[seat]++;
+    }
+
+    void removeCard(int seat, int face) {
+        if (--faceCount[seat][face] == 0) faces[seat] &= ~(1ull << face);
+        colorCount[seat][FACES.color[face]]--;
+        handSize[seat]--;
+    }
+
+    template <class Rng>
+    bool draw(int seat, Rng& rng) {
+        if (pileSize == 0) recycle(rng);
+        if (pileSize == 0) return false;
+        addCard(seat, pile[--pileSize]);
+        return true;
+    }
+
+    // GameState::recycleDiscards() for faces.
+    template <class Rng>
+    void recycle(Rng& rng) {
+        if (discardSize <= 1) return;
+        pileSize = (uint8_t)(discardSize - 1);
+        std::copy(discard, discard + pileSize, pile);
+        discard[0] = discard[pileSize];
+        discardSize = 1;
+        for (uint32_t i = pileSize; i > 1; --i) std::swap(pile[i - 1], pile[randomBelow(rng, i)]);
+    }
+
+    uint64_t playable(int seat) const {
+        return faces[seat] & (FACE_MASKS.color[activeColor] | FACE_MASKS.symbol[topSymbol] | FACE_MASKS.wild);
+    }
+
+    // Wilds are called as the color the seat holds most of.
+    int majorityColor(int seat) const {
+        int best = 0;
+        for (int c = 1; c < 4; ++c) {
+            if (colorCount[seat][c] > colorCount[seat][best]) best = c;
+        }
+        return best;
+    }
+};
+
+void loadPlayout(Playout& playout, const GameState& state);
+
+// Plays `playout` out with the same rules as GameState: every playable face
+// equally likely, a draw (and the turn passed) when nothing is playable.
+// Returns the winning seat, or -1 after maxTurns turns.
+template <class Rng>
+int runPlayout(Playout& p, Rng& rng, uint32_t maxTurns) {
+    while (p.turns < maxTurns) {
+        int seat = p.turn;
+        uint64_t playable = p.playable(seat);
+        if (!playable) {
+            p.draw(seat, rng);
+            p.turn = (uint8_t)p.nextSeat(seat);
+            p.turns++;
+            continue;
+        }
+
+        uint64_t pick = playable;
+        for (int n = (int)randomBelow(rng, countFaces(playable)); n > 0; --n) pick &= pick - 1;
+        int face = lowestFace(pick);
+
+        p.removeCard(seat, face);
+        p.discard[p.discardSize++] = (uint8_t)face;
+        int symbol = FACES.symbol[face];
+        p.topSymbol = (uint8_t)symbol;
+        p.activeColor = (uint8_t)(face >= FIRST_WILD_FACE ? p.majorityColor(seat) : FACES.color[face]);
+
+        bool reverse = symbol == SYMBOL_SKIP + 1;
+        if (reverse) p.direction = (int8_t)-p.direction;
+        int next = p.nextSeat(seat);
+        int penalty = symbol == SYMBOL_SKIP + 2 ? 2 : symbol == SYMBOL_WILD + 1 ? 4 : 0;
+        for (int i = 0; i < penalty && p.draw(next, rng); ++i) {}
+
+        if (p.handSize[seat] == 0) return seat;
+        if (symbol == SYMBOL_SKIP || (reverse && p.seatCount == 2)) next = p.nextSeat(next);
+        p.turn = (uint8_t)next;
+        p.turns++;
+    }
+    return -1;
+}
+
+}
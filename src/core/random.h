@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace uno {
+
+// SplitMix64 step: turns any seed (0 and 1 included) into well-mixed words.
+constexpr uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Seed for the index-th independent stream under `seed`, e.g. one per game
+// or per thread, so results depend on the seed and not on scheduling.
+constexpr uint64_t streamSeed(uint64_t seed, uint64_t index) {
+    uint64_t state = seed ^ (index * 0xD1B54A32D192ED03ull);
+    return splitMix64(state);
+}
+
+// xoshiro256** (Blackman & Vigna): 32 bytes of state, a few cycles per
+// number, and the same sequence for the same seed on every platform. Meets
+// UniformRandomBitGenerator, so it works anywhere an std engine does.
+class Xoshiro256 {
+    public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        for (auto& word : s) word = splitMix64(seed);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s[4];
+};
+
+// Uniform in [0, bound) from any 64-bit generator, by multiply-shift on the
+// high 32 bits instead of a division. The bias is below 2^-25 for bounds up
+// to a deck, and unlike std::uniform_int_distribution the result is the
+// same with every standard library.
+template <class Rng>
+uint32_t randomBelow(Rng& rng, uint32_t bound) {
+    static_assert(Rng::max() == std::numeric_limits<uint64_t>::max() && Rng::min() == 0, "needs a 64-bit generator");
+    return (uint32_t)((rng() >> 32) * bound >> 32);
+}
+
+}
@@ -0,0 +1,115 @@
+#include "core/transposition.h"
+
+#include "core/random.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace uno {
+
+// Card counts per face in one hand: up to 2 of a colored face, 4 of a wild.
+const int MAX_FACE_COUNT = 4;
+
+struct ZobristKeys {
+    uint64_t top[FACE_COUNT];
+    uint64_t color[NONE + 1];
+    uint64_t face[FACE_COUNT][MAX_FACE_COUNT + 1];
+    uint64_t handSize[MAX_SEATS][DECK_SIZE + 1];
+    uint64_t pileSize[DECK_SIZE + 1];
+    uint64_t turn[MAX_SEATS];
+    uint64_t mover[MAX_SEATS];
+    uint64_t reversed;
+};
+
+constexpr ZobristKeys buildZobristKeys() {
+    ZobristKeys keys = {};
+    uint64_t state = 0x554E4F5A4F425249ull;
+    for (auto& key : keys.top) key = splitMix64(state);
+    for (auto& key : keys.color) key = splitMix64(state);
+    for (auto& counts : keys.face) {
+        for (auto& key : counts) key = splitMix64(state);
+    }
+    for (auto& sizes : keys.handSize) {
+        for (auto& key : sizes) key = splitMix64(state);
+    }
+    for (auto& key : keys.pileSize) key = splitMix64(state);
+    for (auto& key : keys.turn) key = splitMix64(state);
+    for (auto& key : keys.mover) key = splitMix64(state);
+    keys.reversed = splitMix64(state);
+    return keys;
+}
+
+static constexpr ZobristKeys ZOBRIST = buildZobristKeys();
+
+uint64_t hashPosition(const GameState& state, int observer, int mover) {
+    uint64_t key = ZOBRIST.top[state.top().face()] ^ ZOBRIST.color[state.activeColor] ^
+                   ZOBRIST.pileSize[state.drawPile.size()] ^ ZOBRIST.turn[state.turn] ^ ZOBRIST.mover[mover];
+
+    if (state.direction < 0) key ^= ZOBRIST.reversed;
+
+    const Hands& hands = state.hands;
+    for (uint64_t faces = hands.faces[observer]; faces; faces &= faces - 1) {
+        int face = lowestFace(faces);
+        key ^= ZOBRIST.face[face][hands.faceCount[observer][face]];
+    }
+    for (int seat = 0; seat < state.seatCount; ++seat) {
+        if (seat != observer) key ^= ZOBRIST.handSize[seat][hands.count[seat]];
+    }
+    return key;
+}
+
+static uint64_t packEntry(TableEntry entry) {
+    uint32_t rewardBits;
+    memcpy(&rewardBits, &entry.reward, sizeof rewardBits);
+    return (uint64_t)entry.visits << 32 | rewardBits;
+}
+
+static TableEntry unpackEntry(uint64_t data) {
+    TableEntry entry;
+    entry.visits = (uint32_t)(data >> 32);
+    uint32_t rewardBits = (uint32_t)data;
+    memcpy(&entry.reward, &rewardBits, sizeof rewardBits);
+    return entry;
+}
+
+TranspositionTable::TranspositionTable(int log2Entries)
+    : slots(new Slot[size_t(1) << min(log2Entries, MAX_TABLE_LOG2)]),
+      mask((uint64_t(1) << min(log2Entries, MAX_TABLE_LOG2)) - 1) {
+    clear();
+}
+
+bool TranspositionTable::probe(uint64_t key, TableEntry& out) const {
+    const Slot& slot = slots[key & mask];
+    uint64_t data = slot.data.load(memory_order_relaxed);
+    uint64_t check = slot.check.load(memory_order_relaxed);
+    if ((check ^ data) != key || data == 0) return false;
+    out = unpackEntry(data);
+    return true;
+}
+
+// A position's entry only gives way to one with at least as many visits: a
+// node seeded from it starts from a capped share of its visits and would
+// otherwise write back a far weaker estimate over it. Another position's
+// entry is always replaced, so old games and lines age out.
+void TranspositionTable::store(uint64_t key, TableEntry entry) {
+    Slot& slot = slots[key & mask];
+    uint64_t stored = slot.data.load(memory_order_relaxed);
+    if ((slot.check.load(memory_order_relaxed) ^ stored) == key && stored != 0 &&
+        unpackEntry(stored).visits > entry.visits) {
+        return;
+    }
+    uint64_t data = packEntry(entry);
+    slot.data.store(data, memory_order_relaxed);
+    slot.check.store(key ^ data, memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        slots[i].check.store(0, memory_order_relaxed);
+        slots[i].data.store(0, memory_order_relaxed);
+    }
+}
+
+}
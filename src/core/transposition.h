@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/game_state.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace uno {
+
+// Zobrist key of a position as `observer` sees it: the top card, the active
+// color, the observer's hand as a multiset of faces, every other hand's size,
+// the draw pile size, whose turn it is and in which direction, and `mover`,
+// the seat whose move led here (the seat the stored reward belongs to).
+uint64_t hashPosition(const GameState& state, int observer, int mover);
+
+// Largest table: 2^26 slots of 16 bytes, 1 GiB. Larger sizes are clamped.
+const int MAX_TABLE_LOG2 = 26;
+
+struct TableEntry {
+    uint32_t visits;
+    float reward;
+};
+
+// Fixed-size hash table of search statistics, shared by every search
+// thread without locks. A slot keeps the better-visited entry of its own
+// position and always gives way to another position (two threads racing on
+// a slot may still lose the larger one). Each slot stores the data word and
+// key ^ data as two independent atomics (Hyatt & Mann's lockless hashing),
+// so a slot torn by a concurrent store fails the key check on probe and
+// reads as a miss instead of returning another position's numbers.
+class TranspositionTable {
+    public:
+    explicit TranspositionTable(int log2Entries);
+
+    bool probe(uint64_t key, TableEntry& out) const;
+    void store(uint64_t key, TableEntry entry);
+    void clear();
+
+    size_t size() const { return mask + 1; }
+
+    private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    uint64_t mask;
+};
+
+}
@@ -0,0 +1,63 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "image_decoder.h"
+#include "texture_cache.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ImageDecoder::ImageDecoder(vector<ImageRequest> requests, const TextureCache* cache, int threads)
+    : requests(move(requests)) {
+    images.resize(this->requests.size());
+    ready.resize(this->requests.size(), 0);
+
+    if (cache) {
+        for (size_t i = 0; i < images.size(); ++i) images[i] = cache->image(i);
+        fill(ready.begin(), ready.end(), 1);
+        cached = true;
+        return;
+    }
+
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min(threads, max(1, (int)this->requests.size()));
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&ImageDecoder::run, this);
+    }
+}
+
+ImageDecoder::~ImageDecoder() {
+    for (auto& worker : workers) worker.join();
+    if (cached) return;
+    for (auto& image : images) stbi_image_free(image.pixels);
+}
+
+void ImageDecoder::run() {
+    for (;;) {
+        size_t index;
+        {
+            lock_guard<mutex> lock(stateMutex);
+            if (nextRequest == requests.size()) return;
+            index = nextRequest++;
+        }
+
+        DecodedImage image;
+        image.pixels = stbi_load(requests[index].path.c_str(), &image.width, &image.height,
+                                 &image.channels, requests[index].channels);
+        if (image.pixels && requests[index].channels != 0) image.channels = requests[index].channels;
+
+        {
+            lock_guard<mutex> lock(stateMutex);
+            images[index] = image;
+            ready[index] = 1;
+        }
+        decoded.notify_all();
+    }
+}
+
+const DecodedImage& ImageDecoder::wait(size_t index) {
+    unique_lock<mutex> lock(stateMutex);
+    decoded.wait(lock, [&] { return ready[index] != 0; });
+    return images[index];
+}
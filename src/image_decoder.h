@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ImageRequest {
+    std::string path;
+    int channels;   // 0 keeps the file's own channel count
+};
+
+class TextureCache;
+
+struct DecodedImage {
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = nullptr;   // null when the file failed to load
+};
+
+// Decodes a batch of images on a pool of worker threads. Images are handed
+// out in request order, so the caller can upload image i while the workers
+// are still inflating the ones after it. Given a fresh TextureCache, no
+// threads are started and every image comes straight out of the cache.
+class ImageDecoder {
+    public:
+    ImageDecoder(std::vector<ImageRequest> requests, const TextureCache* cache = nullptr, int threads = 0);
+    ~ImageDecoder();
+
+    ImageDecoder(const ImageDecoder&) = delete;
+    ImageDecoder& operator=(const ImageDecoder&) = delete;
+
+    size_t size() const { return requests.size(); }
+    int threadCount() const { return (int)workers.size(); }
+    bool fromCache() const { return cached; }
+    const ImageRequest& request(size_t index) const { return requests[index]; }
+    const std::string& path(size_t index) const { return requests[index].path; }
+
+    // Blocks until the image is decoded. Pixels stay valid until the
+    // decoder is destroyed.
+    const DecodedImage& wait(size_t index);
+
+    private:
+    void run();
+
+    std::vector<ImageRequest> requests;
+    std::vector<DecodedImage> images;
+    std::vector<char> ready;
+    size_t nextRequest = 0;
+    bool cached = false;
+
+    std::mutex stateMutex;
+    std::condition_variable decoded;
+    std::vector<std::thread> workers;
+};
@@ -1,4 +1,3 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 #include <glad/glad.h>
@@ -6,23 +5,33 @@
 #include <vector>
 #include <string>
 #include <algorithm>
-#include <random>
 #include <iostream>
 #include <cmath>
-#include <map>
+#include <cstddef>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "core/card.h"
+#include "core/game_state.h"
+#include "core/mcts.h"
+#include "card_textures.h"
+#include "image_decoder.h"
+#include "texture_cache.h"
+#include "profiler.h"
+#include "table_layout.h"
 
 using namespace std;
+using namespace uno;
 
-enum CardColor { RED, GREEN, BLUE, YELLOW, NONE };
-enum CardType { NUMBER, SKIP, REVERSE, DRAW_TWO, WILD, WILD_DRAW_FOUR };
-enum GameState { PLAYER_TURN, AI_TURN, AI_THINKING, WILD_COLOR_SELECT, ANIMATING_PLAYER_PLAY, ANIMATING_PLAYER_DRAW, ANIMATING_AI_PLAY, ANIMATING_AI_DRAW, GAME_OVER_PLAYER_WON, GAME_OVER_AI_WON };
+enum UiState { PLAYER_TURN, AI_TURN, AI_THINKING, WILD_COLOR_SELECT, ANIMATING_PLAYER_PLAY, ANIMATING_PLAYER_DRAW, ANIMATING_AI_PLAY, ANIMATING_AI_DRAW, GAME_OVER_PLAYER_WON, GAME_OVER_AI_WON };
 
-class Card {
+class CardSprite {
     public:
-    CardColor color;
-    CardType type;
-    int number;
-    float x, y;
+    float x = 0.0f, y = 0.0f;
 
     bool isAnimating = false;
     double animDuration = 0.5;
@@ -30,38 +39,67 @@ class Card {
 
     float startX = 0.0f, startY = 0.0f;
     float targetX = 0.0f, targetY = 0.0f;
+
+    // The card's slot in its hand, and a short glide there whenever the
+    // slot moves.
+    float homeX = 0.0f, homeY = 0.0f;
+    bool isSliding = false;
+    double slideTime = 0.0;
+    float slideFromX = 0.0f, slideFromY = 0.0f;
 };
 
-float cardW = 0.15f, cardH = 0.22f;
-vector<Card> playerHand;
-vector<Card> aiHand;
-vector<Card> drawPile;
-vector<Card> discardPile;
+const double CARD_ANIM_SECONDS = 0.5;
+const double SLIDE_SECONDS = 0.2;
+
+GameState game;
+CardSprite sprites[CARD_ID_LIMIT];
 
-GameState gameState = PLAYER_TURN;
+UiState gameState = PLAYER_TURN;
 CardColor wildSelectedColor = NONE;
 double aiThinkingStartTime;
 
+// The AI "thinks" for at least AI_THINK_SECONDS. Its search runs on
+// background threads, so the frame loop only polls searchTask and never
+// waits on it. The same trees live for the whole game: they search on the
+// AI's turn, ponder through the player's, and after every move are carried
+// over to the subtree of the move actually made (lastAction), so the AI
+// starts its turn with the player's reply already explored. Carrying the
+// trees over also happens on the search threads. Pondering stops once a
+// tree holds PONDER_NODES (about 7 MB), which bounds both its memory and
+// the cost of the next carry-over.
+const double AI_THINK_SECONDS = 1.0;
+const size_t PONDER_NODES = 1 << 18;
+double aiSearchBudget = 0.9;
+Xoshiro256 aiRng;
+unique_ptr<ParallelSearch> aiSearch;
+TranspositionTable aiTable(20);
+future<void> searchTask;
+atomic<bool> stopSearch(false);
+int lastAction = -1;
+long aiTurnStartPlayouts = 0;
+
 bool canSelectWildColor = false;
 
-map<string, GLuint> textures;
+Profiler profiler;
+bool showProfiler = false;
+
+GLuint cardTextureArray;
 GLuint backgroundTextureID;
 GLuint playerAvatarID;
 GLuint aiAvatarID;
 GLuint crownTextureID;
 
-GLuint loadTexture(const char* path) {
+GLuint loadTexture(ImageDecoder& decoder, size_t index) {
     GLuint textureID;
     glGenTextures(1, &textureID);
 
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
-    if (data) {
+    const DecodedImage& image = decoder.wait(index);
+    if (image.pixels) {
         GLenum format = GL_RGB;
-        if (nrChannels == 4) format = GL_RGBA;
+        if (image.channels == 4) format = GL_RGBA;
 
         glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
         glGenerateMipmap(GL_TEXTURE_2D);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -69,30 +107,85 @@ GLuint loadTexture(const char* path) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     } else {
-        cout << "Failed to load texture: " << path << endl;
+        cout << "Failed to load texture: " << decoder.path(index) << endl;
         textureID = 0;
     }
-    stbi_image_free(data);
     return textureID;
 }
 
+// Packs every card face into one GL_TEXTURE_2D_ARRAY, one layer per image
+// starting at decoder index `first`, so a whole table of cards can be drawn
+// without rebinding textures. All faces must share the size of the first
+// one; a face that fails to load is left blank.
+GLuint loadTextureArray(ImageDecoder& decoder, size_t first, int layers) {
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+
+    int layerWidth = 0, layerHeight = 0;
+    for (int layer = 0; layer < layers; ++layer) {
+        const DecodedImage& image = decoder.wait(first + layer);
+        if (!image.pixels) {
+            cout << "Failed to load texture: " << decoder.path(first + layer) << endl;
+            continue;
+        }
+        if (layerWidth == 0) {
+            layerWidth = image.width;
+            layerHeight = image.height;
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, image.width, image.height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        if (image.width == layerWidth && image.height == layerHeight) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, image.width, image.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+        } else {
+            cout << "Card texture has the wrong size: " << decoder.path(first + layer) << endl;
+        }
+    }
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return textureID;
+}
+
+// Takes every texture from the decoded-texture cache when it is fresh, and
+// otherwise decodes them on worker threads (uploading each one on this thread
+// as soon as it is ready) and rebuilds the cache. Reports the startup time.
+void loadTextures() {
+    auto start = chrono::steady_clock::now();
+
+    vector<ImageRequest> requests;
+    for (int layer = 0; layer < CARD_LAYER_COUNT; ++layer) {
+        requests.push_back({ cardLayerPath(layer), 4 });
+    }
+    requests.push_back({ "textures/background.png", 0 });
+    requests.push_back({ "textures/player_avatar.png", 0 });
+    requests.push_back({ "textures/ai_avatar.png", 0 });
+    requests.push_back({ "textures/crown.png", 0 });
+
+    TextureCache cache;
+    bool warm = cache.load(TEXTURE_CACHE_PATH, requests);
+    ImageDecoder decoder(requests, warm ? &cache : nullptr);
+    cardTextureArray = loadTextureArray(decoder, 0, CARD_LAYER_COUNT);
+    backgroundTextureID = loadTexture(decoder, CARD_LAYER_COUNT);
+    playerAvatarID = loadTexture(decoder, CARD_LAYER_COUNT + 1);
+    aiAvatarID = loadTexture(decoder, CARD_LAYER_COUNT + 2);
+    crownTextureID = loadTexture(decoder, CARD_LAYER_COUNT + 3);
+    glFinish();
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (decoder.fromCache()) {
+        cout << "Loaded " << decoder.size() << " textures in " << ms << " ms (from " << TEXTURE_CACHE_PATH << ")" << endl;
+    } else {
+        cout << "Loaded " << decoder.size() << " textures in " << ms << " ms ("
+             << decoder.threadCount() << " decode threads)" << endl;
+        if (!TextureCache::save(TEXTURE_CACHE_PATH, decoder)) {
+            cout << "Could not write " << TEXTURE_CACHE_PATH << endl;
+        }
+    }
+}
 
-float cardVerts[] = {
-    -0.5f, -0.7f,    0.0f, 0.0f,
-     0.5f, -0.7f,    1.0f, 0.0f,
-     0.5f,  0.7f,    1.0f, 1.0f,
-    -0.5f,  0.7f,    0.0f, 1.0f
-};
-unsigned int indices[] = {0, 1, 2, 2, 3, 0};
-
-float ui_verts[] = {
-    0.0f, 1.0f,
-    1.0f, 1.0f,
-    1.0f, 0.0f,
-    1.0f, 0.0f,
-    0.0f, 0.0f,
-    0.0f, 1.0f
-};
 
 float backgroundVertices[] = {
     -1.0f,  1.0f,  0.0f, 1.0f,
@@ -148,6 +241,51 @@ void main() {
         FragColor = finalColor;
 }
 )";
+const char* cardVtxSrc = R"(
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec2 iOffset;
+layout(location = 3) in vec2 iScale;
+layout(location = 4) in vec3 iColor;
+layout(location = 5) in float iHighlight;
+layout(location = 6) in float iLayer;
+
+out vec2 TexCoord;
+out vec3 Color;
+out float Highlight;
+out float Layer;
+
+void main() {
+    gl_Position = vec4(aPos * iScale + iOffset, 0.0, 1.0);
+    TexCoord = aTexCoord;
+    Color = iColor;
+    Highlight = iHighlight;
+    Layer = iLayer;
+}
+)";
+const char* cardFragSrc = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec3 Color;
+in float Highlight;
+in float Layer;
+
+uniform sampler2DArray cardTextures;
+
+void main() {
+    vec4 texColor = texture(cardTextures, vec3(TexCoord, Layer));
+    vec4 finalColor = texColor;
+
+    if (texColor.r > 0.9 && texColor.g > 0.9 && texColor.b > 0.9) {
+        finalColor = vec4(Color, 1.0);
+    }
+
+    FragColor = vec4(mix(finalColor.rgb, vec3(1.0), 0.3 * Highlight), finalColor.a);
+}
+)";
 const char* uiVertexShaderSource = R"(
 #version 330 core
 layout(location = 0) in vec2 aPos;
@@ -186,9 +324,38 @@ GLuint createShader(const char* vertexSource, const char* fragmentSource) {
 }
 
 
-void nextTurn();
-void layoutHand();
-void layoutAIHand();
+// The slots a hand was last laid out for. A slot sits at a fixed offset
+// from the hand's origin for as long as the spacing holds, and centring the
+// hand only moves the origin, which glides as one value. Plays, draws and
+// penalties mark a hand dirty and layoutHand() catches up once, moving just
+// the cards from the first changed slot on. Only a change of spacing, while
+// 18 to 36 cards squeeze into the first row, moves every card. The sprite
+// positions of a hand's cards are relative to its origin.
+struct HandLayout : HandSlots {
+    uint8_t ids[DECK_SIZE] = {};
+    size_t count = 0;
+    float originX = 0.0f, originFromX = 0.0f, originToX = 0.0f;
+    double originTime = SLIDE_SECONDS;
+    bool dirty = true;
+};
+
+HandLayout handLayouts[] = { { { -0.7f, 1.0f } }, { { 0.7f, -1.0f } } };    // by seat
+vector<uint8_t> slidingCards;
+
+void markHandDirty(int seat) {
+    handLayouts[seat].dirty = true;
+}
+
+// Per-instance attributes of the card shader, one entry per visible card.
+struct CardInstance {
+    float offsetX, offsetY;
+    float scaleX, scaleY;
+    float r, g, b;
+    float highlight;
+    float layer;
+};
+
+vector<CardInstance> cardInstances;
 
 
 void colorToRGB(CardColor c, float& r, float& g, float& b) {
@@ -201,411 +368,509 @@ void colorToRGB(CardColor c, float& r, float& g, float& b) {
     }
 }
 
-string cardColorToString(CardColor c) {
-    switch(c) {
-        case RED: return "red";
-        case GREEN: return "green";
-        case BLUE: return "blue";
-        case YELLOW: return "yellow";
-        default: return "";
+void layoutPiles() {
+    if (!game.drawPile.empty()) {
+        sprites[game.drawPile.back().id].x = DRAW_PILE_X;
+        sprites[game.drawPile.back().id].y = PILE_Y;
+    }
+    if (!game.discardPile.empty()) {
+        sprites[game.top().id].x = DISCARD_X;
+        sprites[game.top().id].y = PILE_Y;
     }
 }
 
-GLuint getCardTexture(const Card& c) {
-    string key;
-    if (c.type == WILD || c.type == WILD_DRAW_FOUR) {
-        key = "textures/wild/";
-        if (c.type == WILD) key += "wild.png";
-        else key += "wild_draw.png";
-    } else {
-        string colorStr = cardColorToString(c.color);
-        key = "textures/" + colorStr + "/";
-        switch (c.type) {
-            case NUMBER: key += to_string(c.number) + "_" + colorStr + ".png"; break;
-            case SKIP: key += "block_" + colorStr + ".png"; break;
-            case REVERSE: key += "inverse_" + colorStr + ".png"; break;
-            case DRAW_TWO: key += "2plus_" + colorStr + ".png"; break;
-            default: key = "textures/card_back/back.png";
-        }
-    }
+void layoutHand(int seat);
 
-    if (textures.find(key) == textures.end()) {
-        cerr << "Texture not found for key: " << key << endl;
-        return 0;
-    }
-    return textures[key];
+// What is under (x, y), whether or not it is clickable right now.
+Hit pickAt(float x, float y) {
+    layoutHand(PLAYER_SEAT);
+    return pickOnTable(handLayouts[PLAYER_SEAT], handLayouts[PLAYER_SEAT].originX, x, y);
 }
 
-vector<Card> makeDeck() {
-    vector<Card> deck;
-    for (int c = 0; c < 4; ++c) {
-        for (int n = 0; n <= 9; ++n) {
-            Card card = { (CardColor)c, NUMBER, n };
-            deck.push_back(card);
-            if(n!=0) deck.push_back(card);
-        }
-        for (int i = 0; i < 2; ++i) {
-            deck.push_back({ (CardColor)c, SKIP, -1 });
-            deck.push_back({ (CardColor)c, REVERSE, -1 });
-            deck.push_back({ (CardColor)c, DRAW_TWO, -1 });
-        }
-    }
-    for (int i = 0; i < 4; ++i) {
-        deck.push_back({ NONE, WILD, -1 });
-        deck.push_back({ NONE, WILD_DRAW_FOUR, -1 });
+// What the cursor is over. Picked when the cursor moves, and again when the
+// player's slots move under a still cursor.
+float cursorX = -2.0f, cursorY = -2.0f;
+Hit hover = { HIT_NOTHING, 0 };
+bool hoverStale = false;
+
+const float PLAYABLE_HIGHLIGHT = 0.5f;
+const float HOVER_HIGHLIGHT = 1.0f;
+
+// The player's playable faces, recomputed only when the faces in the hand,
+// the top card or the active color change.
+uint64_t playerPlayableFaces() {
+    static uint64_t handFaces = 0, playable = 0;
+    static int topFace = -1;
+    static CardColor color = NONE;
+    uint64_t faces = game.hands.faces[PLAYER_SEAT];
+    if (faces != handFaces || game.top().face() != topFace || game.activeColor != color) {
+        handFaces = faces;
+        topFace = game.top().face();
+        color = game.activeColor;
+        playable = game.playableFaces(PLAYER_SEAT);
     }
-    return deck;
-}
-void shuffle(vector<Card>& v) {
-    static random_device rd;
-    static mt19937 g(rd());
-    shuffle(v.begin(), v.end(), g);
+    return playable;
 }
 
-void layoutPiles() {
-    if (!drawPile.empty()) {
-        drawPile.back().x = -0.7f;
-        drawPile.back().y = 0.0f;
+// Points the card at a new slot. A card in flight is bent towards it, a
+// card new to the hand glides in from the draw pile, any other glides over
+// from where it is.
+void moveToSlot(const HandLayout& layout, size_t slot, Card card, bool fromPile) {
+    CardSprite& sprite = sprites[card.id];
+    float x = layout.slotX[slot], y = layout.slotY[slot];
+    sprite.homeX = x;
+    sprite.homeY = y;
+
+    if (sprite.isAnimating) {
+        sprite.startX = sprite.x;
+        sprite.startY = sprite.y;
+        sprite.targetX = x;
+        sprite.targetY = y;
+        sprite.animDuration = max(0.1, sprite.animDuration - sprite.currentAnimTime);
+        sprite.currentAnimTime = 0.0;
+        return;
+    }
+
+    if (fromPile) {
+        sprite.x = DRAW_PILE_X - layout.originX;
+        sprite.y = PILE_Y;
     }
-    if (!discardPile.empty()) {
-        discardPile.back().x = -0.3f;
-        discardPile.back().y = 0.0f;
+    if (sprite.x == x && sprite.y == y) return;
+    sprite.slideFromX = sprite.x;
+    sprite.slideFromY = sprite.y;
+    sprite.slideTime = 0.0;
+    if (!sprite.isSliding) {
+        sprite.isSliding = true;
+        slidingCards.push_back(card.id);
     }
 }
 
-void layoutHand() {
-    if (playerHand.empty()) return;
+void layoutHand(int seat) {
+    HandLayout& layout = handLayouts[seat];
+    if (!layout.dirty) return;
+    layout.dirty = false;
 
-    float spacing = 0.1f;
-    float totalWidth = (playerHand.size() - 1) * spacing;
-    float startX = -totalWidth / 2.0f;
+    HandView hand = game.hands[seat];
+    bool wasInHand[CARD_ID_LIMIT] = {};
+    for (size_t i = 0; i < layout.count; ++i) wasInHand[layout.ids[i]] = true;
+
+    size_t first = 0;
+    float spacing = handSpacing(hand.size());
+    if (spacing == layout.spacing) {
+        size_t kept = min(hand.size(), layout.count);
+        while (first < kept && hand[first].id == layout.ids[first]) ++first;
+    }
+    layout.spacing = spacing;
+
+    float originX = handOriginX(hand.size(), spacing);
+    if (layout.count == 0) layout.originX = layout.originToX = originX;    // just dealt
+    if (originX != layout.originToX) {
+        layout.originFromX = layout.originX;
+        layout.originToX = originX;
+        layout.originTime = 0.0;
+    }
 
-    for (size_t i = 0; i < playerHand.size(); ++i) {
-        playerHand[i].x = startX + i * spacing;
-        playerHand[i].y = -0.7f;
+    for (size_t i = first; i < hand.size(); ++i) {
+        placeSlot(layout, i);
+        moveToSlot(layout, i, hand[i], !wasInHand[hand[i].id]);
+        layout.ids[i] = hand[i].id;
     }
+    if (hand.size() != layout.count) placeRows(layout, hand.size());
+    layout.count = hand.size();
+    if (seat == PLAYER_SEAT) hoverStale = true;
 }
 
-void layoutAIHand() {
-    if (aiHand.empty()) return;
+// False once the origin is at rest.
+bool updateOrigin(HandLayout& layout, float deltaTime) {
+    if (layout.originTime >= SLIDE_SECONDS) return false;
+    layout.originTime += deltaTime;
+    float t = min(1.0f, (float)(layout.originTime / SLIDE_SECONDS));
+    float ease = t * t * (3.0f - 2.0f * t);
+    layout.originX = layout.originFromX + (layout.originToX - layout.originFromX) * ease;
+    return true;
+}
 
-    float spacing = 0.1f;
-    float totalWidth = (aiHand.size() - 1) * spacing;
-    float startX = -totalWidth / 2.0f;
+// A card played from a hand goes back to table coordinates.
+void leaveHand(int seat, Card card) {
+    sprites[card.id].x += handLayouts[seat].originX;
+}
 
-    for (size_t i = 0; i < aiHand.size(); ++i) {
-        aiHand[i].x = startX + i * spacing;
-        aiHand[i].y = 0.7f;
+void updateSlides(float deltaTime) {
+    size_t kept = 0;
+    for (uint8_t id : slidingCards) {
+        CardSprite& card = sprites[id];
+        if (card.isAnimating) {
+            card.isSliding = false;
+            continue;
+        }
+        card.slideTime += deltaTime;
+        float t = min(1.0f, (float)(card.slideTime / SLIDE_SECONDS));
+        float ease = t * t * (3.0f - 2.0f * t);
+        card.x = card.slideFromX + (card.homeX - card.slideFromX) * ease;
+        card.y = card.slideFromY + (card.homeY - card.slideFromY) * ease;
+        if (t < 1.0f) slidingCards[kept++] = id;
+        else card.isSliding = false;
     }
+    slidingCards.resize(kept);
 }
-bool canPlay(const Card& card, const Card& top) {
-    if (card.type == WILD || card.type == WILD_DRAW_FOUR) return true;
-    if (card.color == top.color) return true;
-    if (card.type == top.type && card.type != NUMBER) return true;
-    if (card.type == NUMBER && top.type == NUMBER && card.number == top.number) return true;
-    return false;
+
+// Resolves a play; penalty draws may have changed either hand.
+void resolvePlay(int seat) {
+    game.resolvePlay(seat);
+    markHandDirty(PLAYER_SEAT);
+    markHandDirty(AI_SEAT);
+}
+
+// A budget of 0 ponders until finishSearch(). The trees are first carried
+// over past `played`, unless it is -1.
+void startSearch(double budget, int played) {
+    SearchOptions options;
+    options.timeBudget = budget;
+    if (budget == 0.0) options.nodeLimit = PONDER_NODES;
+    options.stop = &stopSearch;
+    options.table = &aiTable;
+    stopSearch = false;
+    searchTask = async(launch::async, [options, played, state = game] {
+        if (played >= 0) aiSearch->advance(played, state);
+        aiSearch->run(options);
+    });
 }
 
-void nextTurn() {
-    if (gameState == PLAYER_TURN || gameState == ANIMATING_PLAYER_PLAY || gameState == ANIMATING_PLAYER_DRAW) {
+void finishSearch() {
+    if (!searchTask.valid()) return;
+    stopSearch = true;
+    searchTask.get();
+}
+
+void syncTurn() {
+    finishSearch();
+    int played = lastAction;
+    lastAction = -1;
+
+    if (game.isOver()) {
+        if (game.winner == PLAYER_SEAT) {
+            gameState = GAME_OVER_PLAYER_WON;
+            cout << "Player Won!\n";
+        } else {
+            gameState = GAME_OVER_AI_WON;
+            cout << "AI Won!\n";
+        }
+    } else if (game.turn == AI_SEAT) {
         gameState = AI_THINKING;
         aiThinkingStartTime = glfwGetTime();
+        aiTurnStartPlayouts = aiSearch->stats().playouts;
+        startSearch(aiSearchBudget, played);
     } else {
         gameState = PLAYER_TURN;
+        startSearch(0.0, played);
     }
 }
 
+// Hand cards pass their hand's origin, as their sprites are relative to it.
+void pushCardInstance(Card card, CardColor tint, int layer, float highlight = 0.0f, float originX = 0.0f) {
+    CardInstance instance;
+    instance.offsetX = sprites[card.id].x + originX;
+    instance.offsetY = sprites[card.id].y;
+    instance.scaleX = CARD_W;
+    instance.scaleY = CARD_H;
+    colorToRGB(tint, instance.r, instance.g, instance.b);
+    instance.highlight = highlight;
+    instance.layer = layer;
+    cardInstances.push_back(instance);
+}
 
-void applyCardEffect(const Card& playedCard) {
-    if (playedCard.type == DRAW_TWO) {
-        if (gameState == ANIMATING_PLAYER_PLAY) {
-            for(int i = 0; i < 2; ++i) {
-                if (drawPile.empty()) break;
-                aiHand.push_back(drawPile.back());
-                drawPile.pop_back();
-            }
-            layoutAIHand();
-        } else {
-            for(int i = 0; i < 2; ++i) {
-                if (drawPile.empty()) break;
-                playerHand.push_back(drawPile.back());
-                drawPile.pop_back();
-            }
-            layoutHand();
+// Backs are drawn untinted: white keeps the white of the texture.
+void pushCardBack(Card card, float highlight = 0.0f, float originX = 0.0f) {
+    pushCardInstance(card, NONE, CARD_BACK_LAYER, highlight, originX);
+    CardInstance& instance = cardInstances.back();
+    instance.r = instance.g = instance.b = 1.0f;
+}
+
+// Rebuilds the card instance list for this frame in back-to-front order.
+// On the player's turn the playable cards are lit, the hovered one most.
+void buildCardInstances() {
+    cardInstances.clear();
+    bool playerTurn = gameState == PLAYER_TURN;
+
+    if (!game.drawPile.empty()) {
+        bool hovered = playerTurn && hover.kind == HIT_DRAW_PILE;
+        pushCardBack(game.drawPile.back(), hovered ? HOVER_HIGHLIGHT : 0.0f);
+    }
+    if (!game.discardPile.empty()) {
+        pushCardInstance(game.top(), game.activeColor, getCardTexture(game.top()));
+    }
+    // Hands go row by row, back rows first.
+    const HandLayout& player = handLayouts[PLAYER_SEAT];
+    HandView hand = game.hands[PLAYER_SEAT];
+    uint64_t playable = playerTurn ? playerPlayableFaces() : 0;
+    int hovered = playerTurn && hover.kind == HIT_HAND_CARD ? hover.index : -1;
+    for (size_t r = player.rows.size(); r-- > 0; ) {
+        for (size_t i = player.rows[r].first; i < player.rows[r].first + player.rows[r].count; ++i) {
+            Card card = hand[i];
+            float highlight = 0.0f;
+            if ((int)i == hovered) highlight = HOVER_HIGHLIGHT;
+            else if (playable >> card.face() & 1) highlight = PLAYABLE_HIGHLIGHT;
+            pushCardInstance(card, card.color(), getCardTexture(card), highlight, player.originX);
         }
-        nextTurn();
-    } else if (playedCard.type == SKIP || playedCard.type == REVERSE) {
-        nextTurn();
-        nextTurn();
-    } else {
-        nextTurn();
     }
-
-    if (playerHand.empty()) {
-        gameState = GAME_OVER_PLAYER_WON;
-        cout << "Player Won!\n";
-    } else if (aiHand.empty()) {
-        gameState = GAME_OVER_AI_WON;
-        cout << "AI Won!\n";
+    const HandLayout& ai = handLayouts[AI_SEAT];
+    for (size_t r = ai.rows.size(); r-- > 0; ) {
+        for (size_t i = ai.rows[r].first; i < ai.rows[r].first + ai.rows[r].count; ++i) {
+            pushCardBack(game.hands[AI_SEAT][i], 0.0f, ai.originX);
+        }
     }
-    layoutPiles();
 }
-void startCardAnimation(Card& card, float targetX, float targetY) {
+
+// Uploads this frame's instances in one buffer write and draws every card
+// with a single instanced call.
+void drawCardInstances(GLuint instanceVBO) {
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, cardInstances.size() * sizeof(CardInstance), cardInstances.data(), GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, cardTextureArray);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, cardInstances.size());
+}
+
+void startCardAnimation(CardSprite& card, float targetX, float targetY) {
     card.startX = card.x;
     card.startY = card.y;
     card.targetX = targetX;
     card.targetY = targetY;
     card.isAnimating = true;
+    card.animDuration = CARD_ANIM_SECONDS;
     card.currentAnimTime = 0.0;
 }
 
+// The card has just been drawn by `seat`: fly it from the draw pile to its
+// slot in the hand.
+void startDrawAnimation(int seat, Card card) {
+    markHandDirty(seat);
+    layoutHand(seat);
+    CardSprite& sprite = sprites[card.id];
+    sprite.x = DRAW_PILE_X - handLayouts[seat].originX;
+    sprite.y = PILE_Y;
+    startCardAnimation(sprite, sprite.homeX, sprite.homeY);
+}
+
+bool stepCardAnimation(CardSprite& card, float deltaTime) {
+    card.currentAnimTime += deltaTime;
+    float progress = min(1.0f, (float)(card.currentAnimTime / card.animDuration));
+
+    card.x = card.startX + (card.targetX - card.startX) * progress;
+    card.y = card.startY + (card.targetY - card.startY) * progress;
+
+    if (progress < 1.0f) return false;
+    card.x = card.targetX;
+    card.y = card.targetY;
+    card.isAnimating = false;
+    return true;
+}
+
 void updateAnimations(float deltaTime) {
     if (gameState == ANIMATING_PLAYER_PLAY) {
-        Card& card = discardPile.back();
-        card.currentAnimTime += deltaTime;
-        float progress = min(1.0f, (float)(card.currentAnimTime / card.animDuration));
-
-        card.x = card.startX + (card.targetX - card.startX) * progress;
-        card.y = card.startY + (card.targetY - card.startY) * progress;
-
-        if (progress >= 1.0f) {
-            card.x = card.targetX;
-            card.y = card.targetY;
-            card.isAnimating = false;
-
-            if (card.type == WILD || card.type == WILD_DRAW_FOUR) {
-                if (card.type == WILD_DRAW_FOUR) {
-                    for(int i = 0; i < 4; ++i) {
-                        if (drawPile.empty()) break;
-                        aiHand.push_back(drawPile.back());
-                        drawPile.pop_back();
-                    }
-                    layoutAIHand();
-                }
+        if (stepCardAnimation(sprites[game.top().id], deltaTime)) {
+            if (isWild(game.top())) {
                 gameState = WILD_COLOR_SELECT;
-                discardPile.back().color = NONE;
-
                 canSelectWildColor = true;
             } else {
-                applyCardEffect(card);
+                resolvePlay(PLAYER_SEAT);
+                syncTurn();
             }
-            layoutHand();
             layoutPiles();
         }
     }
 
     if (gameState == ANIMATING_PLAYER_DRAW) {
-        Card& card = playerHand.back();
-        card.currentAnimTime += deltaTime;
-        float progress = min(1.0f, (float)(card.currentAnimTime / card.animDuration));
-
-        card.x = card.startX + (card.targetX - card.startX) * progress;
-        card.y = card.startY + (card.targetY - card.startY) * progress;
-
-        if (progress >= 1.0f) {
-            card.x = card.targetX;
-            card.y = card.targetY;
-            card.isAnimating = false;
-            nextTurn();
-            layoutHand();
+        if (stepCardAnimation(sprites[game.hands[PLAYER_SEAT].back().id], deltaTime)) {
+            game.nextTurn();
+            syncTurn();
             layoutPiles();
         }
     }
 
     if (gameState == ANIMATING_AI_PLAY) {
-        Card& card = discardPile.back();
-        card.currentAnimTime += deltaTime;
-        float progress = min(1.0f, (float)(card.currentAnimTime / card.animDuration));
-
-        card.x = card.startX + (card.targetX - card.startX) * progress;
-        card.y = card.startY + (card.targetY - card.startY) * progress;
-
-        if (progress >= 1.0f) {
-            card.x = card.targetX;
-            card.y = card.targetY;
-            card.isAnimating = false;
-
-            if (card.type == WILD_DRAW_FOUR) {
-                for(int i = 0; i < 4; ++i) {
-                    if (drawPile.empty()) break;
-                    playerHand.push_back(drawPile.back());
-                    drawPile.pop_back();
-                }
-                layoutHand();
-            } else if (card.type != WILD) {
-                applyCardEffect(card);
-            }
-
-            layoutAIHand();
+        if (stepCardAnimation(sprites[game.top().id], deltaTime)) {
+            resolvePlay(AI_SEAT);
             layoutPiles();
-            if (card.type == WILD || card.type == WILD_DRAW_FOUR) {
-                nextTurn();
-            }
+            syncTurn();
         }
     }
 
     if (gameState == ANIMATING_AI_DRAW) {
-        Card& card = aiHand.back();
-        card.currentAnimTime += deltaTime;
-        float progress = min(1.0f, (float)(card.currentAnimTime / card.animDuration));
-
-        card.x = card.startX + (card.targetX - card.startX) * progress;
-        card.y = card.startY + (card.targetY - card.startY) * progress;
-
-        if (progress >= 1.0f) {
-            card.x = card.targetX;
-            card.y = card.targetY;
-            card.isAnimating = false;
-            nextTurn();
-            layoutAIHand();
+        if (stepCardAnimation(sprites[game.hands[AI_SEAT].back().id], deltaTime)) {
+            game.nextTurn();
+            syncTurn();
             layoutPiles();
         }
     }
 }
 
-
-void aiTurn() {
-    Card& top = discardPile.back();
-    int playIndex = -1;
-    for(size_t i = 0; i < aiHand.size(); ++i) {
-        if(canPlay(aiHand[i], top)) {
-            playIndex = i;
-            break;
-        }
+// Once a frame, after every hand change of the frame, game over included.
+void updateHandLayout(float deltaTime) {
+    layoutHand(PLAYER_SEAT);
+    layoutHand(AI_SEAT);
+    updateSlides(deltaTime);
+    if (updateOrigin(handLayouts[PLAYER_SEAT], deltaTime)) hoverStale = true;
+    updateOrigin(handLayouts[AI_SEAT], deltaTime);
+    if (hoverStale) {
+        hover = pickAt(cursorX, cursorY);
+        hoverStale = false;
     }
+}
 
-    if (playIndex != -1) {
-        Card playedCard = aiHand[playIndex];
 
-        playedCard.x = aiHand[playIndex].x;
-        playedCard.y = aiHand[playIndex].y;
+void aiTurn(Move move) {
+    SearchStats stats = aiSearch->stats();
+    long searched = stats.playouts - aiTurnStartPlayouts;
+    cout << "AI move after " << aiSearch->rootPlayouts() << " playouts, " << searched << " of them this turn ("
+         << (long)stats.playoutsPerSecond() << " playouts/sec on " << aiSearch->threadCount() << " threads, "
+         << (int)(100.0 * stats.tableHitRate()) << "% table hits)\n";
 
-        discardPile.push_back(playedCard);
-        aiHand.erase(aiHand.begin() + playIndex);
+    lastAction = move.index != -1 ? cardAction(game.hands[AI_SEAT][move.index], move.color) : ACTION_DRAW;
 
-        if (playedCard.type == WILD || playedCard.type == WILD_DRAW_FOUR) {
-            int colorCount[4] = {0, 0, 0, 0};
-            for(const auto& card : aiHand) {
-                if (card.color != NONE) {
-                    colorCount[card.color]++;
-                }
-            }
-            int maxCount = 0;
-            int maxColor = 0;
-            for(int i = 0; i < 4; ++i) {
-                if (colorCount[i] > maxCount) {
-                    maxCount = colorCount[i];
-                    maxColor = i;
-                }
-            }
-            discardPile.back().color = (CardColor)maxColor;
-        }
+    if (move.index != -1) {
+        leaveHand(AI_SEAT, game.hands[AI_SEAT][move.index]);
+        game.playCard(AI_SEAT, move.index, move.color);
+        markHandDirty(AI_SEAT);
 
-        startCardAnimation(discardPile.back(), -0.3f, 0.0f);
+        startCardAnimation(sprites[game.top().id], DISCARD_X, PILE_Y);
         gameState = ANIMATING_AI_PLAY;
         layoutPiles();
 
     } else {
-        if(!drawPile.empty()) {
-            Card drawnCard = drawPile.back();
-            drawPile.pop_back();
-
-            drawnCard.x = -0.7f;
-            drawnCard.y = 0.0f;
-            aiHand.push_back(drawnCard);
-
-            startCardAnimation(aiHand.back(), aiHand.back().x, aiHand.back().y);
+        if (game.drawCard(AI_SEAT)) {
+            startDrawAnimation(AI_SEAT, game.hands[AI_SEAT].back());
             gameState = ANIMATING_AI_DRAW;
             layoutPiles();
         } else {
-            nextTurn();
+            game.nextTurn();
+            syncTurn();
         }
     }
 }
 
+void toScreen(GLFWwindow* window, double mx, double my, float& x, float& y) {
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    x = (mx / width) * 2.0f - 1.0f;
+    y = 1.0f - (my / height) * 2.0f;
+}
+
+void cursor_pos_callback(GLFWwindow* window, double mx, double my) {
+    toScreen(window, mx, my, cursorX, cursorY);
+    hover = pickAt(cursorX, cursorY);
+}
+
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (gameState != PLAYER_TURN &&
-        (gameState != ANIMATING_PLAYER_PLAY ||
-         (discardPile.empty() || (discardPile.back().type != WILD && discardPile.back().type != WILD_DRAW_FOUR))) &&
+        (gameState != ANIMATING_PLAYER_PLAY || !isWild(game.top())) &&
         gameState != WILD_COLOR_SELECT) {
         return;
     }
 
     double mx, my;
     glfwGetCursorPos(window, &mx, &my);
-    int width, height;
-    glfwGetWindowSize(window, &width, &height);
-    float x = (mx / width) * 2.0f - 1.0f;
-    float y = 1.0f - (my / height) * 2.0f;
+    float x, y;
+    toScreen(window, mx, my, x, y);
 
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+        Hit hit = pickAt(x, y);
         if (gameState == PLAYER_TURN) {
-            Card& top = discardPile.back();
-
-            if (!drawPile.empty()) {
-                Card& pileCard = drawPile.back();
-                if (abs(x - pileCard.x) < cardW * 0.5f && abs(y - pileCard.y) < cardH * 0.5f) {
-                    Card drawnCard = drawPile.back();
-                    drawPile.pop_back();
-                    drawnCard.x = pileCard.x;
-                    drawnCard.y = pileCard.y;
-                    playerHand.push_back(drawnCard);
-
-                    layoutPiles();
-                    layoutHand();
-                    startCardAnimation(playerHand.back(), playerHand.back().x, playerHand.back().y);
-                    gameState = ANIMATING_PLAYER_DRAW;
-                    return;
-                }
+            if (hit.kind == HIT_DRAW_PILE && !game.drawPile.empty()) {
+                game.drawCard(PLAYER_SEAT);
+                lastAction = ACTION_DRAW;
+
+                layoutPiles();
+                startDrawAnimation(PLAYER_SEAT, game.hands[PLAYER_SEAT].back());
+                gameState = ANIMATING_PLAYER_DRAW;
+                return;
             }
 
-            for (size_t i = playerHand.size(); i-- > 0; ) {
-                Card& card = playerHand[i];
-                if (abs(x - card.x) < cardW * 0.5f && abs(y - card.y) < cardH * 0.5f) {
-                    if (canPlay(card, top)) {
-                        Card playedCard = card;
-
-                        playedCard.x = card.x;
-                        playedCard.y = card.y;
-
-                        discardPile.push_back(playedCard);
-                        playerHand.erase(playerHand.begin() + i);
-
-                        startCardAnimation(discardPile.back(), -0.3f, 0.0f);
-                        gameState = ANIMATING_PLAYER_PLAY;
-                        layoutPiles();
-                        return;
-                    }
-                }
+            HandView hand = game.hands[PLAYER_SEAT];
+            int i = hit.index;
+            if (hit.kind == HIT_HAND_CARD && (playerPlayableFaces() >> hand[i].face() & 1)) {
+                CardSprite& card = sprites[hand[i].id];
+                if (!isWild(hand[i])) lastAction = cardAction(hand[i], NONE);
+                leaveHand(PLAYER_SEAT, hand[i]);
+                game.playCard(PLAYER_SEAT, i);
+                markHandDirty(PLAYER_SEAT);
+
+                startCardAnimation(card, DISCARD_X, PILE_Y);
+                gameState = ANIMATING_PLAYER_PLAY;
+                layoutPiles();
+                return;
             }
         }
 
         if ((gameState == WILD_COLOR_SELECT ||
-            (gameState == ANIMATING_PLAYER_PLAY && !discardPile.empty() &&
-             (discardPile.back().type == WILD || discardPile.back().type == WILD_DRAW_FOUR))) && canSelectWildColor) {
-
-            if (y > 0.1f && y < 0.3f) {
-                CardColor selectedColor = NONE;
-                if (x > -0.6f && x < -0.4f) {
-                    selectedColor = RED;
-                } else if (x > -0.2f && x < 0.0f) {
-                    selectedColor = GREEN;
-                } else if (x > 0.2f && x < 0.4f) {
-                    selectedColor = BLUE;
-                } else if (x > 0.6f && x < 0.8f) {
-                    selectedColor = YELLOW;
-                }
-                if (selectedColor != NONE) {
-                    discardPile.back().color = selectedColor;
-                    nextTurn();
-                    layoutPiles();
-                    canSelectWildColor = false;
-                }
+            (gameState == ANIMATING_PLAYER_PLAY && isWild(game.top()))) && canSelectWildColor) {
+
+            if (hit.kind == HIT_COLOR_BUTTON) {
+                CardColor selectedColor = (CardColor)hit.index;
+                game.chooseColor(selectedColor);
+                lastAction = cardAction(game.top(), selectedColor);
+                resolvePlay(PLAYER_SEAT);
+                layoutPiles();
+                canSelectWildColor = false;
+                syncTurn();
             }
         }
     }
 }
 
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (action != GLFW_PRESS) return;
+
+    if (key == GLFW_KEY_F1) {
+        showProfiler = !showProfiler;
+    } else if (key == GLFW_KEY_F2) {
+        bool ok = profiler.writeCsv("profile.csv") && profiler.writeChromeTrace("profile_trace.json");
+        cout << (ok ? "Wrote profile.csv and profile_trace.json\n" : "Could not write the profile dump\n");
+    }
+}
+
+// One row per phase, top left: the CPU bar over a darker GPU bar, scaled so
+// a 60 Hz frame budget (16.7 ms) spans half the screen. The white row on
+// top is the whole frame.
+void drawProfilerOverlay(GLint uiPosLoc, GLint uiSizeLoc, GLint uiColorLoc, GLint uiAlphaLoc) {
+    const float phaseColors[PHASE_COUNT][3] = {
+        { 0.9f, 0.6f, 0.2f },
+        { 0.8f, 0.3f, 0.8f },
+        { 0.3f, 0.6f, 0.9f },
+        { 0.3f, 0.9f, 0.4f },
+        { 0.9f, 0.9f, 0.3f },
+    };
+    float unitsPerMs = 1.0f / 16.7f;
+    float left = -0.98f, top = 0.97f, rowH = 0.045f, barH = 0.018f;
+
+    glUniform1f(uiAlphaLoc, 0.6f);
+    glUniform2f(uiPosLoc, left - 0.01f, top - rowH * (PHASE_COUNT + 1) - 0.01f);
+    glUniform2f(uiSizeLoc, 1.0f, rowH * (PHASE_COUNT + 1) + 0.02f);
+    glUniform3f(uiColorLoc, 0.0f, 0.0f, 0.0f);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glUniform1f(uiAlphaLoc, 0.9f);
+    glUniform2f(uiPosLoc, left, top - rowH + (rowH - barH));
+    glUniform2f(uiSizeLoc, profiler.averageFrameMs() * unitsPerMs, barH);
+    glUniform3f(uiColorLoc, 1.0f, 1.0f, 1.0f);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        const float* c = phaseColors[phase];
+        float rowTop = top - rowH * (phase + 2);
+
+        glUniform2f(uiPosLoc, left, rowTop + barH);
+        glUniform2f(uiSizeLoc, profiler.averageCpuMs((ProfilePhase)phase) * unitsPerMs, barH);
+        glUniform3f(uiColorLoc, c[0], c[1], c[2]);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        glUniform2f(uiPosLoc, left, rowTop);
+        glUniform2f(uiSizeLoc, profiler.averageGpuMs((ProfilePhase)phase) * unitsPerMs, barH);
+        glUniform3f(uiColorLoc, c[0] * 0.5f, c[1] * 0.5f, c[2] * 0.5f);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+    glUniform1f(uiAlphaLoc, 1.0f);
+}
+
 
 int main() {
     if (!glfwInit()) return -1;
@@ -620,33 +885,17 @@ int main() {
 
     stbi_set_flip_vertically_on_load(true);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetCursorPosCallback(window, cursor_pos_callback);
+    glfwSetKeyCallback(window, key_callback);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     GLuint shaderProg = createShader(vtxSrc, fragSrc);
+    GLuint cardShader = createShader(cardVtxSrc, cardFragSrc);
     GLuint uiShader = createShader(uiVertexShaderSource, uiFragmentShaderSource);
 
-    for (int c = 0; c < 4; ++c) {
-        string colorStr = cardColorToString((CardColor)c);
-        for (int n = 0; n <= 9; ++n) {
-            string path = "textures/" + colorStr + "/" + to_string(n) + "_" + colorStr + ".png";
-            textures[path] = loadTexture(path.c_str());
-        }
-        string pathSkip = "textures/" + colorStr + "/block_" + colorStr + ".png";
-        textures[pathSkip] = loadTexture(pathSkip.c_str());
-        string pathReverse = "textures/" + colorStr + "/inverse_" + colorStr + ".png";
-        textures[pathReverse] = loadTexture(pathReverse.c_str());
-        string pathDrawTwo = "textures/" + colorStr + "/2plus_" + colorStr + ".png";
-        textures[pathDrawTwo] = loadTexture(pathDrawTwo.c_str());
-    }
-    textures["textures/wild/wild.png"] = loadTexture("textures/wild/wild.png");
-    textures["textures/wild/wild_draw.png"] = loadTexture("textures/wild/wild_draw.png");
-    textures["textures/card_back/back.png"] = loadTexture("textures/card_back/back.png");
-
-    backgroundTextureID = loadTexture("textures/background.png");
-    playerAvatarID = loadTexture("textures/player_avatar.png");
-    aiAvatarID = loadTexture("textures/ai_avatar.png");
-    crownTextureID = loadTexture("textures/crown.png");
+    loadTextures();
+    profiler.init();
 
     GLuint VAO, VBO, EBO;
     glGenVertexArrays(1, &VAO);
@@ -654,20 +903,42 @@ int main() {
     glGenBuffers(1, &EBO);
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cardVerts), cardVerts, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(CARD_VERTS), CARD_VERTS, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(CARD_INDICES), CARD_INDICES, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
+    GLuint cardVAO, instanceVBO;
+    glGenVertexArrays(1, &cardVAO);
+    glGenBuffers(1, &instanceVBO);
+    glBindVertexArray(cardVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)offsetof(CardInstance, offsetX));
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)offsetof(CardInstance, scaleX));
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)offsetof(CardInstance, r));
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)offsetof(CardInstance, highlight));
+    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(CardInstance), (void*)offsetof(CardInstance, layer));
+    for (GLuint attrib = 2; attrib <= 6; ++attrib) {
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribDivisor(attrib, 1);
+    }
+    cardInstances.reserve(DECK_SIZE);
+
     GLuint uiVAO, uiVBO;
     glGenVertexArrays(1, &uiVAO);
     glGenBuffers(1, &uiVBO);
     glBindVertexArray(uiVAO);
     glBindBuffer(GL_ARRAY_BUFFER, uiVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(ui_verts), ui_verts, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(UI_VERTS), UI_VERTS, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
@@ -698,25 +969,21 @@ int main() {
     GLint uiAlphaLoc = glGetUniformLocation(uiShader, "alpha");
 
 
-    vector<Card> deck = makeDeck();
-    shuffle(deck);
-    playerHand.clear();
-    aiHand.clear();
+    // Logged so a game can be replayed by hard-coding the seed here.
+    uint64_t seed = (uint64_t)random_device{}() << 32 | random_device{}();
+    cout << "Game seed " << seed << "\n";
+    Xoshiro256 dealRng(streamSeed(seed, 0));
+    aiRng.seed(streamSeed(seed, 1));
 
-    for (int i = 0; i < 7; ++i) {
-        playerHand.push_back(deck.back());
-        deck.pop_back();
-        aiHand.push_back(deck.back());
-        deck.pop_back();
-    }
-    drawPile = deck;
-    discardPile.clear();
-    discardPile.push_back(drawPile.back());
-    drawPile.pop_back();
-    layoutHand();
-    layoutAIHand();
+    CardPile deck = makeDeck();
+    shuffle(deck, dealRng);
+    game.deal(deck, streamSeed(seed, 2));
     layoutPiles();
 
+    // Leave a core for the render thread.
+    aiSearch = make_unique<ParallelSearch>(game, AI_SEAT, max(1, (int)thread::hardware_concurrency() - 1), aiRng());
+    syncTurn();
+
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
 
@@ -729,15 +996,23 @@ int main() {
         glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
+        profiler.beginFrame();
         if (gameState != GAME_OVER_PLAYER_WON && gameState != GAME_OVER_AI_WON) {
-            updateAnimations(deltaTime);
+            {
+                ProfileScope scope(profiler, PHASE_UPDATE);
+                updateAnimations(deltaTime);
+            }
             if (gameState == AI_THINKING) {
-                if (glfwGetTime() - aiThinkingStartTime > 1.0) {
-                    aiTurn();
+                if (glfwGetTime() - aiThinkingStartTime > AI_THINK_SECONDS &&
+                    searchTask.wait_for(chrono::seconds(0)) == future_status::ready) {
+                    ProfileScope scope(profiler, PHASE_AI);
+                    aiTurn(aiSearch->bestMove());
                 }
             }
         }
+        updateHandLayout(deltaTime);
 
+        profiler.begin(PHASE_BACKGROUND);
         glUseProgram(shaderProg);
         glBindVertexArray(backgroundVAO);
         glBindTexture(GL_TEXTURE_2D, backgroundTextureID);
@@ -784,81 +1059,26 @@ int main() {
         glUniform2f(scaleLoc, avatarSize, avatarSize);
         glUniform1f(highlightLoc, 0.0f);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        profiler.end(PHASE_BACKGROUND);
 
-        glUseProgram(shaderProg);
-        glBindVertexArray(VAO);
-        if (!drawPile.empty()) {
-            glUniform2f(offsetLoc, drawPile.back().x, drawPile.back().y);
-            glUniform2f(scaleLoc, cardW, cardH);
-            glUniform3f(colorLoc, 1.0f, 1.0f, 1.0f);
-            glUniform1f(highlightLoc, 0.0f);
-            glUniform1i(hasTextureLoc, 1);
-            glUniform1i(isWildLoc, 0);
-            glBindTexture(GL_TEXTURE_2D, textures["textures/card_back/back.png"]);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        }
-        if (!discardPile.empty()) {
-            float r, g, b;
-            Card& top = discardPile.back();
-            colorToRGB(top.color, r, g, b);
-            glUniform2f(offsetLoc, top.x, top.y);
-            glUniform2f(scaleLoc, cardW, cardH);
-            glUniform3f(colorLoc, r, g, b);
-            glUniform1f(highlightLoc, 0.0f);
-            glUniform1i(hasTextureLoc, 1);
-            glUniform1i(isWildLoc, top.type == WILD || top.type == WILD_DRAW_FOUR);
-            glBindTexture(GL_TEXTURE_2D, getCardTexture(top));
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        }
-        for (const auto& card : playerHand) {
-            float r, g, b;
-            colorToRGB(card.color, r, g, b);
-            glUniform2f(offsetLoc, card.x, card.y);
-            glUniform2f(scaleLoc, cardW, cardH);
-            glUniform3f(colorLoc, r, g, b);
-            glUniform1f(highlightLoc, 0.0f);
-            glUniform1i(hasTextureLoc, 1);
-            glUniform1i(isWildLoc, card.type == WILD || card.type == WILD_DRAW_FOUR);
-            glBindTexture(GL_TEXTURE_2D, getCardTexture(card));
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        }
-        for (const auto& card : aiHand) {
-            glUniform2f(offsetLoc, card.x, card.y);
-            glUniform2f(scaleLoc, cardW, cardH);
-            glUniform3f(colorLoc, 1.0f, 1.0f, 1.0f);
-            glUniform1f(highlightLoc, 0.0f);
-            glUniform1i(hasTextureLoc, 1);
-            glUniform1i(isWildLoc, 0);
-            glBindTexture(GL_TEXTURE_2D, textures["textures/card_back/back.png"]);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        }
+        profiler.begin(PHASE_CARDS);
+        buildCardInstances();
+        glUseProgram(cardShader);
+        glBindVertexArray(cardVAO);
+        drawCardInstances(instanceVBO);
+        profiler.end(PHASE_CARDS);
 
+        profiler.begin(PHASE_UI);
         glUseProgram(uiShader);
         glBindVertexArray(uiVAO);
         glUniform1f(uiAlphaLoc, 1.0f);
         if (gameState == WILD_COLOR_SELECT) {
-            float uiW = 0.2f;
-            float uiH = 0.2f;
-
-            glUniform2f(uiPosLoc, -0.6f, 0.1f);
-            glUniform2f(uiSizeLoc, uiW, uiH);
-            glUniform3f(uiColorLoc, 1.0f, 0.2f, 0.2f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            glUniform2f(uiPosLoc, -0.2f, 0.1f);
-            glUniform2f(uiSizeLoc, uiW, uiH);
-            glUniform3f(uiColorLoc, 0.2f, 1.0f, 0.2f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            glUniform2f(uiPosLoc, 0.2f, 0.1f);
-            glUniform2f(uiSizeLoc, uiW, uiH);
-            glUniform3f(uiColorLoc, 0.2f, 0.4f, 1.0f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            glUniform2f(uiPosLoc, 0.6f, 0.1f);
-            glUniform2f(uiSizeLoc, uiW, uiH);
-            glUniform3f(uiColorLoc, 1.0f, 1.0f, 0.2f);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+            for (const ColorButton& button : COLOR_BUTTONS) {
+                glUniform2f(uiPosLoc, button.x, COLOR_BUTTON_Y);
+                glUniform2f(uiSizeLoc, COLOR_BUTTON_SIZE, COLOR_BUTTON_SIZE);
+                glUniform3f(uiColorLoc, button.r, button.g, button.b);
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+            }
         }
 
         glUseProgram(shaderProg);
@@ -878,19 +1098,34 @@ int main() {
             glUniform2f(scaleLoc, crownSize, crownSize);
             glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         }
+        profiler.end(PHASE_UI);
+
+        if (showProfiler) {
+            glUseProgram(uiShader);
+            glBindVertexArray(uiVAO);
+            drawProfilerOverlay(uiPosLoc, uiSizeLoc, uiColorLoc, uiAlphaLoc);
+        }
+        profiler.endFrame();
 
         glfwSwapBuffers(window);
     }
 
+    finishSearch();
+    profiler.shutdown();
+
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    glDeleteVertexArrays(1, &cardVAO);
+    glDeleteBuffers(1, &instanceVBO);
     glDeleteVertexArrays(1, &uiVAO);
     glDeleteBuffers(1, &uiVBO);
     glDeleteVertexArrays(1, &backgroundVAO);
     glDeleteBuffers(1, &backgroundVBO);
     glDeleteBuffers(1, &backgroundEBO);
     glDeleteProgram(shaderProg);
+    glDeleteTextures(1, &cardTextureArray);
+    glDeleteProgram(cardShader);
     glDeleteProgram(uiShader);
     glfwTerminate();
     return 0;
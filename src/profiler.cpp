@@ -0,0 +1,162 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+void Profiler::init() {
+    origin = chrono::steady_clock::now();
+    frames.assign(PROFILER_HISTORY, FrameProfile());
+    for (auto& frameQueries : queries) glGenQueries(PHASE_COUNT, frameQueries);
+}
+
+void Profiler::shutdown() {
+    for (auto& frameQueries : queries) glDeleteQueries(PHASE_COUNT, frameQueries);
+}
+
+double Profiler::nowMs() const {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - origin).count();
+}
+
+const FrameProfile& Profiler::history(int age) const {
+    return frames[(frameIndex - age + PROFILER_HISTORY) % PROFILER_HISTORY];
+}
+
+void Profiler::beginFrame() {
+    ++frameIndex;
+    FrameProfile& frame = frames[frameIndex % PROFILER_HISTORY];
+    frame = FrameProfile();
+    frame.startMs = nowMs();
+    fill(frame.gpuMs, frame.gpuMs + PHASE_COUNT, -1.0);
+
+    int slot = frameIndex % PROFILER_QUERY_FRAMES;
+    fill(queryIssued[slot], queryIssued[slot] + PHASE_COUNT, false);
+    queryFrame[slot] = frameIndex;
+}
+
+void Profiler::endFrame() {
+    FrameProfile& frame = frames[frameIndex % PROFILER_HISTORY];
+    frame.frameMs = nowMs() - frame.startMs;
+    collectQueries();
+}
+
+void Profiler::begin(ProfilePhase phase) {
+    phaseStart[phase] = nowMs();
+    int slot = frameIndex % PROFILER_QUERY_FRAMES;
+    glBeginQuery(GL_TIME_ELAPSED, queries[slot][phase]);
+    queryIssued[slot][phase] = true;
+}
+
+void Profiler::end(ProfilePhase phase) {
+    glEndQuery(GL_TIME_ELAPSED);
+    FrameProfile& frame = frames[frameIndex % PROFILER_HISTORY];
+    frame.cpuStartMs[phase] = phaseStart[phase] - frame.startMs;
+    frame.cpuMs[phase] += nowMs() - phaseStart[phase];
+}
+
+// Reads back the oldest frame's queries. The driver may still have that
+// frame queued, and reading an unfinished result would block until the GPU
+// catches up, so a phase whose result is not available yet keeps -1 and is
+// left out of the averages. Its query is reissued next frame either way.
+void Profiler::collectQueries() {
+    long oldest = frameIndex - (PROFILER_QUERY_FRAMES - 1);
+    if (oldest < 0 || frameIndex - oldest >= PROFILER_HISTORY) return;
+
+    int slot = oldest % PROFILER_QUERY_FRAMES;
+    if (queryFrame[slot] != oldest) return;
+    FrameProfile& frame = frames[oldest % PROFILER_HISTORY];
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        if (!queryIssued[slot][phase]) {
+            frame.gpuMs[phase] = 0.0;
+            continue;
+        }
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[slot][phase], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[slot][phase], GL_QUERY_RESULT, &ns);
+        frame.gpuMs[phase] = ns / 1.0e6;
+    }
+}
+
+double Profiler::averageCpuMs(ProfilePhase phase, int count) const {
+    count = min<long>(count, min<long>(frameIndex, PROFILER_HISTORY - 1));
+    if (count <= 0) return 0.0;
+    double sum = 0.0;
+    for (int age = 1; age <= count; ++age) sum += history(age).cpuMs[phase];
+    return sum / count;
+}
+
+double Profiler::averageGpuMs(ProfilePhase phase, int count) const {
+    double sum = 0.0;
+    int used = 0;
+    for (int age = 1; age <= min<long>(frameIndex, PROFILER_HISTORY - 1) && used < count; ++age) {
+        if (history(age).gpuMs[phase] < 0.0) continue;
+        sum += history(age).gpuMs[phase];
+        ++used;
+    }
+    return used ? sum / used : 0.0;
+}
+
+double Profiler::averageFrameMs(int count) const {
+    count = min<long>(count, min<long>(frameIndex, PROFILER_HISTORY - 1));
+    if (count <= 0) return 0.0;
+    double sum = 0.0;
+    for (int age = 1; age <= count; ++age) sum += history(age).frameMs;
+    return sum / count;
+}
+
+bool Profiler::writeCsv(const string& path) const {
+    ofstream out(path);
+    if (!out) return false;
+
+    out << "frame,start_ms,frame_ms";
+    for (const char* name : PHASE_NAMES) out << "," << name << "_cpu_ms";
+    for (const char* name : PHASE_NAMES) out << "," << name << "_gpu_ms";
+    out << "\n";
+
+    long count = min<long>(frameIndex, PROFILER_HISTORY - 1);
+    for (long age = count; age >= 1; --age) {
+        const FrameProfile& frame = history(age);
+        out << frameIndex - age << "," << frame.startMs << "," << frame.frameMs;
+        for (double ms : frame.cpuMs) out << "," << ms;
+        for (double ms : frame.gpuMs) out << "," << ms;
+        out << "\n";
+    }
+    return (bool)out;
+}
+
+// Chrome trace event format (chrome://tracing, Perfetto): CPU phases on
+// thread 1, GPU phases on thread 2 laid out back to back from the CPU
+// submission time, since elapsed-time queries carry no GPU timestamp.
+bool Profiler::writeChromeTrace(const string& path) const {
+    ofstream out(path);
+    if (!out) return false;
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto event = [&](const char* name, int tid, double startMs, double durMs) {
+        out << (first ? "" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":" << startMs * 1000.0 << ",\"dur\":" << durMs * 1000.0 << "}";
+        first = false;
+    };
+
+    long count = min<long>(frameIndex, PROFILER_HISTORY - 1);
+    for (long age = count; age >= 1; --age) {
+        const FrameProfile& frame = history(age);
+        event("frame", 1, frame.startMs, frame.frameMs);
+        double gpuStart = frame.startMs;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            if (frame.cpuMs[phase] <= 0.0) continue;
+            event(PHASE_NAMES[phase], 1, frame.startMs + frame.cpuStartMs[phase], frame.cpuMs[phase]);
+            if (frame.gpuMs[phase] > 0.0) {
+                gpuStart = max(gpuStart, frame.startMs + frame.cpuStartMs[phase]);
+                event(PHASE_NAMES[phase], 2, gpuStart, frame.gpuMs[phase]);
+                gpuStart += frame.gpuMs[phase];
+            }
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return (bool)out;
+}
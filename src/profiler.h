@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+enum ProfilePhase { PHASE_UPDATE, PHASE_AI, PHASE_BACKGROUND, PHASE_CARDS, PHASE_UI, PHASE_COUNT };
+
+const char* const PHASE_NAMES[PHASE_COUNT] = { "update", "ai", "background", "cards", "ui" };
+
+// Frames of GL timer queries kept in flight, so results are read back a few
+// frames late; a result still not ready by then is dropped rather than
+// waited for.
+const int PROFILER_QUERY_FRAMES = 4;
+// Frames of history kept for averaging and for the dump files.
+const int PROFILER_HISTORY = 600;
+
+struct FrameProfile {
+    double startMs = 0.0;                     // since the profiler started
+    double frameMs = 0.0;                     // CPU time from beginFrame to endFrame
+    double cpuStartMs[PHASE_COUNT] = {};      // relative to startMs
+    double cpuMs[PHASE_COUNT] = {};
+    double gpuMs[PHASE_COUNT] = {};           // -1 until the query result arrives
+};
+
+// Per-phase CPU timers and GL_TIME_ELAPSED queries for the main loop. Each
+// phase may be entered at most once per frame, and phases must not nest,
+// since only one GL_TIME_ELAPSED query can be active at a time.
+class Profiler {
+    public:
+    void init();
+    void shutdown();
+
+    void beginFrame();
+    void endFrame();
+    void begin(ProfilePhase phase);
+    void end(ProfilePhase phase);
+
+    // Averages over the last `frames` frames with complete results.
+    double averageCpuMs(ProfilePhase phase, int frames = 60) const;
+    double averageGpuMs(ProfilePhase phase, int frames = 60) const;
+    double averageFrameMs(int frames = 60) const;
+
+    bool writeCsv(const std::string& path) const;
+    bool writeChromeTrace(const std::string& path) const;
+
+    private:
+    double nowMs() const;
+    void collectQueries();
+    const FrameProfile& history(int age) const;
+
+    std::chrono::steady_clock::time_point origin;
+    GLuint queries[PROFILER_QUERY_FRAMES][PHASE_COUNT] = {};
+    bool queryIssued[PROFILER_QUERY_FRAMES][PHASE_COUNT] = {};
+    long queryFrame[PROFILER_QUERY_FRAMES] = {};
+
+    std::vector<FrameProfile> frames;
+    long frameIndex = -1;
+    double phaseStart[PHASE_COUNT] = {};
+};
+
+class ProfileScope {
+    public:
+    ProfileScope(Profiler& profiler, ProfilePhase phase) : profiler(profiler), phase(phase) { profiler.begin(phase); }
+    ~ProfileScope() { profiler.end(phase); }
+
+    private:
+    Profiler& profiler;
+    ProfilePhase phase;
+};
@@ -0,0 +1,189 @@
+#include "core/card.h"
+#include "core/game_state.h"
+#include "core/mcts.h"
+#include "core/playout.h"
+#include "core/transposition.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace uno;
+
+// Games handed to a worker per grab from the shared counter: big enough that
+// the atomic is not contended, small enough to balance the tail across cores.
+const long GAMES_PER_CHUNK = 4096;
+
+struct SimOptions {
+    long games = 1000000;
+    int threads = 0;
+    unsigned long long seed = 1;
+    long maxTurns = 2000;
+    int seats = MIN_SEATS;
+    // Seat AI_SEAT searches with IS-MCTS when either limit is set.
+    long playouts = 0;
+    double budgetMs = 0.0;
+    int searchThreads = 1;
+    int tableBits = 0;            // log2 of transposition table entries per game thread, 0 = none
+    bool randomPlayouts = false;  // play random playouts with the search's kernel instead of AI games
+
+    bool useSearch() const { return playouts > 0 || budgetMs > 0.0; }
+};
+
+struct alignas(64) SimStats {
+    long games = 0;
+    long wins[MAX_SEATS] = {};
+    long unfinished = 0;
+    long turns = 0;
+    long playouts = 0;
+    double searchSeconds = 0.0;
+    long tableProbes = 0;
+    long tableHits = 0;
+};
+
+void usage(const char* argv0) {
+    cout << "usage: " << argv0 << " [-g games] [-t threads] [-s seed] [-n seats] [-m max-turns] [-p playouts] [-b budget-ms] [-j search-threads] [-x table-log2-entries (max 26)] [-r 0|1]\n";
+}
+
+bool parseOptions(int argc, char** argv, SimOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) return false;
+        const char* flag = argv[i];
+        const char* value = argv[++i];
+        if (!strcmp(flag, "-g")) opts.games = atol(value);
+        else if (!strcmp(flag, "-t")) opts.threads = atoi(value);
+        else if (!strcmp(flag, "-s")) opts.seed = strtoull(value, nullptr, 10);
+        else if (!strcmp(flag, "-n")) opts.seats = atoi(value);
+        else if (!strcmp(flag, "-m")) opts.maxTurns = atol(value);
+        else if (!strcmp(flag, "-p")) opts.playouts = atol(value);
+        else if (!strcmp(flag, "-b")) opts.budgetMs = atof(value);
+        else if (!strcmp(flag, "-j")) opts.searchThreads = atoi(value);
+        else if (!strcmp(flag, "-x")) opts.tableBits = atoi(value);
+        else if (!strcmp(flag, "-r")) opts.randomPlayouts = atoi(value) != 0;
+        else return false;
+    }
+    return opts.games > 0 && opts.threads >= 0 && opts.seats >= MIN_SEATS && opts.seats <= MAX_SEATS &&
+           opts.maxTurns > 0 && opts.playouts >= 0 && opts.budgetMs >= 0.0 && opts.searchThreads >= 0 &&
+           opts.tableBits >= 0 && opts.tableBits <= MAX_TABLE_LOG2;
+}
+
+// Like playGame(), but AI_SEAT picks its moves with a search.
+int playSearchGame(GameState& state, const SimOptions& opts, Xoshiro256& rng, TranspositionTable* table, SimStats& stats) {
+    SearchOptions search;
+    search.timeBudget = opts.budgetMs / 1000.0;
+    search.maxPlayouts = opts.playouts;
+    search.threads = opts.searchThreads;
+    search.table = table;
+
+    while (!state.isOver() && state.turnCount < opts.maxTurns) {
+        if (state.turn != AI_SEAT) {
+            takeAiTurn(state);
+            continue;
+        }
+        SearchStats moveStats;
+        applyMove(state, searchMove(state, AI_SEAT, search, rng(), &moveStats));
+        stats.playouts += moveStats.playouts;
+        stats.searchSeconds += moveStats.seconds;
+        stats.tableProbes += moveStats.tableProbes;
+        stats.tableHits += moveStats.tableHits;
+    }
+    return state.winner;
+}
+
+void runWorker(const SimOptions& opts, atomic<long>& nextGame, SimStats& out) {
+    const CardPile fresh = makeDeck();
+    CardPile deck;
+    GameState state;
+    SimStats stats;
+    // Kept across games: keys are whole positions, so entries stay valid.
+    unique_ptr<TranspositionTable> table;
+    if (opts.tableBits > 0) table = make_unique<TranspositionTable>(opts.tableBits);
+
+    for (;;) {
+        long first = nextGame.fetch_add(GAMES_PER_CHUNK, memory_order_relaxed);
+        if (first >= opts.games) break;
+        long last = min(opts.games, first + GAMES_PER_CHUNK);
+
+        for (long g = first; g < last; ++g) {
+            // A stream per game, not per thread: the results depend only on
+            // the seed, whatever the thread count and chunk scheduling.
+            Xoshiro256 rng(streamSeed(opts.seed, g));
+            deck = fresh;
+            shuffle(deck, rng);
+            state.deal(deck, rng(), opts.seats);
+
+            int winner;
+            if (opts.randomPlayouts) {
+                Playout playout;
+                loadPlayout(playout, state);
+                winner = runPlayout(playout, rng, (uint32_t)opts.maxTurns);
+                state.turnCount = playout.turns;
+            } else if (opts.useSearch()) {
+                winner = playSearchGame(state, opts, rng, table.get(), stats);
+            } else {
+                winner = playGame(state, opts.maxTurns);
+            }
+            if (winner >= 0) stats.wins[winner]++;
+            else stats.unfinished++;
+            stats.turns += state.turnCount;
+            stats.games++;
+        }
+    }
+    out = stats;
+}
+
+int main(int argc, char** argv) {
+    SimOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (opts.threads == 0) opts.threads = max(1u, thread::hardware_concurrency());
+
+    atomic<long> nextGame(0);
+    vector<SimStats> perThread(opts.threads);
+    vector<thread> workers;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < opts.threads; ++i) {
+        workers.emplace_back(runWorker, cref(opts), ref(nextGame), ref(perThread[i]));
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    SimStats total;
+    for (const auto& stats : perThread) {
+        total.games += stats.games;
+        for (int seat = 0; seat < opts.seats; ++seat) total.wins[seat] += stats.wins[seat];
+        total.unfinished += stats.unfinished;
+        total.turns += stats.turns;
+        total.playouts += stats.playouts;
+        total.searchSeconds += stats.searchSeconds;
+        total.tableProbes += stats.tableProbes;
+        total.tableHits += stats.tableHits;
+    }
+
+    cout << "games:        " << total.games << " on " << opts.threads << " threads, " << opts.seats << " seats, seed " << opts.seed << "\n";
+    cout << "time:         " << seconds << " s\n";
+    cout << "games/sec:    " << total.games / seconds << "\n";
+    cout << "turns/sec:    " << total.turns / seconds << "\n";
+    for (int seat = 0; seat < opts.seats; ++seat) {
+        cout << "seat " << seat << " wins:  " << 100.0 * total.wins[seat] / total.games << " %\n";
+    }
+    cout << "unfinished:   " << 100.0 * total.unfinished / total.games << " % (cap " << opts.maxTurns << " turns)\n";
+    cout << "avg length:   " << (double)total.turns / total.games << " turns\n";
+    if (opts.useSearch()) {
+        cout << "playouts/sec: " << total.playouts / total.searchSeconds << " per game thread (seat " << AI_SEAT << " search)\n";
+        if (opts.tableBits > 0) {
+            cout << "table hits:   " << 100.0 * total.tableHits / max(1L, total.tableProbes) << " % of "
+                 << total.tableProbes << " probes\n";
+        }
+    }
+    return 0;
+}
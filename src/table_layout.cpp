@@ -0,0 +1,73 @@
+#include "table_layout.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+float handSpacing(size_t count) {
+    size_t wide = min(count, CARDS_PER_ROW);
+    return wide > 1 ? min(HAND_SPACING, MAX_HAND_WIDTH / (wide - 1)) : HAND_SPACING;
+}
+
+float handOriginX(size_t count, float spacing) {
+    size_t wide = max<size_t>(1, min(count, CARDS_PER_ROW));
+    return -(float)(wide - 1) * spacing / 2.0f;
+}
+
+void placeSlot(HandSlots& hand, size_t i) {
+    hand.slotX[i] = (i % CARDS_PER_ROW) * hand.spacing;
+    hand.slotY[i] = hand.y + (i / CARDS_PER_ROW) * HAND_ROW_STEP * hand.inward;
+}
+
+void placeRows(HandSlots& hand, size_t count) {
+    hand.rows.clear();
+    for (size_t first = 0; first < count; first += CARDS_PER_ROW) {
+        hand.rows.push_back({ hand.slotY[first], first, min(CARDS_PER_ROW, count - first) });
+    }
+}
+
+// Rows are tried front to back, each over the full height of the drawn
+// quad, except that a back row only answers for the strip the row in front
+// of it leaves in view (a row in front is always full, so it covers every
+// card behind it sideways). Within a row cards are drawn left to right, so
+// the card on top is the last one whose left edge is left of x: a binary
+// search.
+int handSlotAt(const HandSlots& hand, float x, float y) {
+    const float halfW = CARD_W * CARD_QUAD_HALF_W, halfH = CARD_H * CARD_QUAD_HALF_H;
+    for (size_t r = 0; r < hand.rows.size(); ++r) {
+        const HandRow& row = hand.rows[r];
+        if (abs(y - row.y) >= halfH) continue;
+        if (r > 0 && (y - hand.rows[r - 1].y) * hand.inward < halfH) continue;
+        const float* begin = hand.slotX + row.first;
+        const float* above = upper_bound(begin, begin + row.count, x + halfW);
+        if (above != begin && x - above[-1] < halfW) return (int)(above - 1 - hand.slotX);
+    }
+    return -1;
+}
+
+// The draw pile's rect is the card quad at the pile, the buttons' the UI
+// quad (the unit square) scaled to the button.
+const vector<HitRect>& widgetRects() {
+    static const vector<HitRect> rects = [] {
+        const float halfW = CARD_W * CARD_QUAD_HALF_W, halfH = CARD_H * CARD_QUAD_HALF_H;
+        vector<HitRect> built;
+        built.push_back({ DRAW_PILE_X - halfW, PILE_Y - halfH, DRAW_PILE_X + halfW, PILE_Y + halfH,
+                          { HIT_DRAW_PILE, 0 } });
+        for (const ColorButton& button : COLOR_BUTTONS) {
+            built.push_back({ button.x, COLOR_BUTTON_Y, button.x + COLOR_BUTTON_SIZE,
+                              COLOR_BUTTON_Y + COLOR_BUTTON_SIZE, { HIT_COLOR_BUTTON, button.color } });
+        }
+        return built;
+    }();
+    return rects;
+}
+
+Hit pickOnTable(const HandSlots& hand, float originX, float x, float y) {
+    for (const HitRect& rect : widgetRects()) {
+        if (x > rect.left && x < rect.right && y > rect.bottom && y < rect.top) return rect.hit;
+    }
+    int slot = handSlotAt(hand, x - originX, y);
+    if (slot != -1) return { HIT_HAND_CARD, slot };
+    return { HIT_NOTHING, 0 };
+}
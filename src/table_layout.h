@@ -0,0 +1,107 @@
+#pragma once
+
+#include "core/card.h"
+
+#include <cstddef>
+#include <vector>
+
+// Where cards and widgets sit on the table, in clip space. Rendering and
+// mouse picking both read these, and nothing here touches GL, so
+// src/check/picking.cpp can compare picks with the drawn quads.
+
+const float CARD_W = 0.15f, CARD_H = 0.22f;
+
+// Half the card quad's extent, in units of the card's scale: a card drawn
+// at (x, y) covers x +- CARD_QUAD_HALF_W * CARD_W and y +- CARD_QUAD_HALF_H * CARD_H.
+const float CARD_QUAD_HALF_W = 0.5f, CARD_QUAD_HALF_H = 0.7f;
+
+// Position and texture coordinate of each corner of the card quad.
+const float CARD_VERTS[] = {
+    -CARD_QUAD_HALF_W, -CARD_QUAD_HALF_H,    0.0f, 0.0f,
+     CARD_QUAD_HALF_W, -CARD_QUAD_HALF_H,    1.0f, 0.0f,
+     CARD_QUAD_HALF_W,  CARD_QUAD_HALF_H,    1.0f, 1.0f,
+    -CARD_QUAD_HALF_W,  CARD_QUAD_HALF_H,    0.0f, 1.0f
+};
+const unsigned int CARD_INDICES[] = { 0, 1, 2, 2, 3, 0 };
+
+// Two triangles over the unit square; a UI quad covers position to
+// position + size.
+const float UI_VERTS[] = {
+    0.0f, 1.0f,
+    1.0f, 1.0f,
+    1.0f, 0.0f,
+    1.0f, 0.0f,
+    0.0f, 0.0f,
+    0.0f, 1.0f
+};
+
+const float DRAW_PILE_X = -0.7f, DISCARD_X = -0.3f, PILE_Y = 0.0f;
+
+// A hand spreads up to MAX_HAND_WIDTH between its outer card centres,
+// overlapping its cards down to MIN_HAND_SPACING before it starts another
+// row.
+const float HAND_SPACING = 0.1f;
+const float MIN_HAND_SPACING = 0.045f;
+const float MAX_HAND_WIDTH = 1.6f;
+const float HAND_ROW_STEP = 0.09f;
+
+const size_t CARDS_PER_ROW = (size_t)(MAX_HAND_WIDTH / MIN_HAND_SPACING) + 1;
+
+struct HandRow {
+    float y;
+    size_t first, count;
+};
+
+// The slots of a hand, relative to its origin, and its rows. Cards fill
+// rows of CARDS_PER_ROW in hand order: the first row along the table edge
+// in front, later ones further in behind it with their top edge in view.
+struct HandSlots {
+    float y;
+    float inward;    // +1 or -1, the direction of the middle of the table
+    float slotX[uno::DECK_SIZE] = {}, slotY[uno::DECK_SIZE] = {};
+    std::vector<HandRow> rows = {};    // front to back
+    float spacing = HAND_SPACING;
+};
+
+// The spacing depends only on how full the first row is.
+float handSpacing(size_t count);
+// The origin that centres the first row of `count` cards.
+float handOriginX(size_t count, float spacing);
+void placeSlot(HandSlots& hand, size_t i);
+void placeRows(HandSlots& hand, size_t count);
+// The topmost slot under (x, y), x relative to the hand's origin, or -1.
+int handSlotAt(const HandSlots& hand, float x, float y);
+
+// Things the mouse can pick besides the hand, in front of every card.
+enum HitKind { HIT_NOTHING, HIT_HAND_CARD, HIT_DRAW_PILE, HIT_COLOR_BUTTON };
+
+struct Hit {
+    HitKind kind;
+    int index;    // the hand slot, or the color of a button
+};
+
+struct HitRect {
+    float left, bottom, right, top;
+    Hit hit;
+};
+
+struct ColorButton {
+    uno::CardColor color;
+    float x;
+    float r, g, b;
+};
+
+const ColorButton COLOR_BUTTONS[] = {
+    { uno::RED, -0.6f, 1.0f, 0.2f, 0.2f },
+    { uno::GREEN, -0.2f, 0.2f, 1.0f, 0.2f },
+    { uno::BLUE, 0.2f, 0.2f, 0.4f, 1.0f },
+    { uno::YELLOW, 0.6f, 1.0f, 1.0f, 0.2f },
+};
+const float COLOR_BUTTON_Y = 0.1f;
+const float COLOR_BUTTON_SIZE = 0.2f;
+
+const std::vector<HitRect>& widgetRects();
+
+// What is under (x, y) on a table whose player hand has its origin at
+// originX, whether or not it is clickable right now.
+Hit pickOnTable(const HandSlots& hand, float originX, float x, float y);
@@ -0,0 +1,181 @@
+#include "texture_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char CACHE_MAGIC[8] = { 'U', 'N', 'O', 'T', 'E', 'X', '0', '1' };
+const size_t CACHE_ALIGNMENT = 64;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct CacheEntry {
+    char path[128];
+    int64_t sourceTime;
+    uint64_t sourceSize;
+    int32_t requestedChannels;
+    int32_t width, height, channels;
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+bool statSource(const string& path, int64_t& time, uint64_t& size) {
+    error_code ec;
+    auto mtime = filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    auto bytes = filesystem::file_size(path, ec);
+    if (ec) return false;
+    time = (int64_t)mtime.time_since_epoch().count();
+    size = bytes;
+    return true;
+}
+
+// The pixels are width * height * channels bytes in the requested channel
+// count, and lie inside the file. Callers upload that many bytes straight
+// from the mapping, so an entry that disagrees with itself is stale or
+// corrupt, however well its offsets fit.
+bool entryConsistent(const CacheEntry& entry, size_t dataSize) {
+    if (entry.width <= 0 || entry.height <= 0 || entry.channels < 1 || entry.channels > 4) return false;
+    if (entry.requestedChannels != 0 && entry.channels != entry.requestedChannels) return false;
+    return entry.bytes == (uint64_t)entry.width * entry.height * entry.channels &&
+           entry.bytes <= dataSize && entry.offset <= dataSize - entry.bytes;
+}
+
+const CacheEntry* entries(const unsigned char* data) {
+    return (const CacheEntry*)(data + sizeof(CacheHeader));
+}
+
+}
+
+TextureCache::~TextureCache() {
+    unmap();
+}
+
+void TextureCache::unmap() {
+#ifndef _WIN32
+    if (data && fallback.empty()) munmap((void*)data, dataSize);
+#endif
+    fallback.clear();
+    data = nullptr;
+    dataSize = 0;
+}
+
+bool TextureCache::load(const string& path, const vector<ImageRequest>& requests) {
+    unmap();
+
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data = (const unsigned char*)mapping;
+            dataSize = st.st_size;
+        }
+    }
+    close(fd);
+#else
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    fallback.resize(ftell(file));
+    fseek(file, 0, SEEK_SET);
+    if (fread(fallback.data(), 1, fallback.size(), file) == fallback.size() && !fallback.empty()) {
+        data = fallback.data();
+        dataSize = fallback.size();
+    }
+    fclose(file);
+#endif
+    if (!data) return false;
+
+    const CacheHeader* header = (const CacheHeader*)data;
+    bool fresh = dataSize >= sizeof(CacheHeader) &&
+                 memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                 header->count == requests.size() &&
+                 dataSize >= sizeof(CacheHeader) + header->count * sizeof(CacheEntry);
+
+    for (size_t i = 0; fresh && i < requests.size(); ++i) {
+        const CacheEntry& entry = entries(data)[i];
+        int64_t time;
+        uint64_t size;
+        fresh = strncmp(entry.path, requests[i].path.c_str(), sizeof(entry.path)) == 0 &&
+                entry.requestedChannels == requests[i].channels &&
+                entryConsistent(entry, dataSize) &&
+                statSource(requests[i].path, time, size) &&
+                entry.sourceTime == time && entry.sourceSize == size;
+    }
+    if (!fresh) unmap();
+    return fresh;
+}
+
+DecodedImage TextureCache::image(size_t index) const {
+    const CacheEntry& entry = entries(data)[index];
+    DecodedImage image;
+    image.width = entry.width;
+    image.height = entry.height;
+    image.channels = entry.channels;
+    image.pixels = (unsigned char*)(data + entry.offset);
+    return image;
+}
+
+bool TextureCache::save(const string& path, ImageDecoder& decoder) {
+    vector<CacheEntry> table(decoder.size());
+    uint64_t offset = sizeof(CacheHeader) + table.size() * sizeof(CacheEntry);
+    for (size_t i = 0; i < decoder.size(); ++i) {
+        const DecodedImage& image = decoder.wait(i);
+        CacheEntry& entry = table[i];
+        memset(&entry, 0, sizeof(entry));
+        if (!image.pixels || decoder.path(i).size() >= sizeof(entry.path)) return false;
+        if (!statSource(decoder.path(i), entry.sourceTime, entry.sourceSize)) return false;
+
+        strncpy(entry.path, decoder.path(i).c_str(), sizeof(entry.path) - 1);
+        entry.requestedChannels = decoder.request(i).channels;
+        entry.width = image.width;
+        entry.height = image.height;
+        entry.channels = image.channels;
+        offset = (offset + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+        entry.offset = offset;
+        entry.bytes = (uint64_t)image.width * image.height * image.channels;
+        offset += entry.bytes;
+    }
+
+    string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.count = table.size();
+    header.reserved = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(table.data(), sizeof(CacheEntry), table.size(), file) == table.size();
+    for (size_t i = 0; ok && i < table.size(); ++i) {
+        ok = fseek(file, table[i].offset, SEEK_SET) == 0 &&
+             fwrite(decoder.wait(i).pixels, 1, table[i].bytes, file) == table[i].bytes;
+    }
+    ok = fclose(file) == 0 && ok;
+
+    error_code ec;
+    if (ok) filesystem::rename(tempPath, path, ec);
+    if (!ok || ec) {
+        filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
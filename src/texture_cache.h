@@ -0,0 +1,37 @@
+#pragma once
+
+#include "image_decoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const char* const TEXTURE_CACHE_PATH = "texture_cache.bin";
+
+// Already-decoded pixels for a batch of image requests, kept in a single
+// file that is memory-mapped on load, so a warm start skips PNG inflate
+// entirely. The cache is all-or-nothing: it is only used when it was built
+// from exactly the same requests and every source file still has the
+// modification time and size it had when the cache was written.
+class TextureCache {
+    public:
+    TextureCache() = default;
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    bool load(const std::string& path, const std::vector<ImageRequest>& requests);
+    // Points into the mapping; valid for the lifetime of the cache.
+    DecodedImage image(size_t index) const;
+
+    static bool save(const std::string& path, ImageDecoder& decoder);
+
+    private:
+    void unmap();
+
+    const unsigned char* data = nullptr;
+    size_t dataSize = 0;
+    std::vector<unsigned char> fallback;
+};